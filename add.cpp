@@ -4,6 +4,9 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 namespace MiniGit {
 
@@ -18,6 +21,79 @@ static std::string normalizePath(const std::string& path) {
     }
 }
 
+namespace {
+    // Staging-file hash of a staged removal
+    const std::string REMOVED = "-";
+
+    // List one directory, splitting entries into files to stage and
+    // subdirectories to descend into. Ignored and out-of-cone entries are
+    // dropped here, so whole build-output trees are never opened.
+    void scanDirectory(const std::string& dir,
+                       std::vector<std::string>& files,
+                       std::vector<std::string>& subdirs) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        for (fs::directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec), end;
+             !ec && it != end; it.increment(ec)) {
+            std::string name = it->path().filename().generic_string();
+            std::string path = dir == "." ? name : dir + "/" + name;
+
+            std::error_code typeError;
+            if (it->is_directory(typeError) && !it->is_symlink(typeError)) {
+                if (!IgnoreRules::isIgnored(path, true) && SparseCheckout::containsDirectory(path)) {
+                    subdirs.push_back(std::move(path));
+                }
+            } else if (it->is_regular_file(typeError)) {
+                if (!IgnoreRules::isIgnored(path, false) && SparseCheckout::contains(path)) {
+                    files.push_back(std::move(path));
+                }
+            }
+        }
+    }
+}
+
+// Every non-ignored, in-cone file below root, walked with one shared work
+// stack across the worker pool
+std::vector<std::string> FileAdder::listFiles(const std::string& root) {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::string> pending{root};
+    std::vector<std::string> files;
+    size_t busy = 0;
+
+    auto worker = [&] {
+        std::vector<std::string> localFiles;
+        std::vector<std::string> subdirs;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&] { return !pending.empty() || busy == 0; });
+            if (pending.empty()) break;
+
+            std::string dir = std::move(pending.back());
+            pending.pop_back();
+            ++busy;
+            lock.unlock();
+            scanDirectory(dir, localFiles, subdirs);
+            lock.lock();
+            --busy;
+
+            for (auto& subdir : subdirs) pending.push_back(std::move(subdir));
+            subdirs.clear();
+            wake.notify_all();
+        }
+        files.insert(files.end(), std::make_move_iterator(localFiles.begin()),
+                     std::make_move_iterator(localFiles.end()));
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < Utils::workerCount(); ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
 bool FileAdder::addFile(const std::string& filename) {
     if (!Initializer::isInitialized()) {
         std::cerr << "Error: Repository not initialized\n";
@@ -26,41 +102,52 @@ bool FileAdder::addFile(const std::string& filename) {
 
     std::string normalized = normalizePath(filename);
 
+    // A tracked file that is gone from the working tree stages its removal
+    if (!std::filesystem::exists(normalized) &&
+        (getStagedEntries().count(normalized) ||
+         MergeManager::getCommitFiles(RefStore::resolveHead()).count(normalized))) {
+        std::ofstream staging(Constants::STAGING_FILE, std::ios::app);
+        if (!staging) {
+            std::cerr << "Error: Could not open staging file\n";
+            return false;
+        }
+        staging << normalized << " " << REMOVED << "\n";
+        std::cout << "Removed file " << normalized << "\n";
+        return true;
+    }
+
     // Check if file exists
     if (!std::filesystem::exists(normalized)) {
         std::cerr << "Error: File " << normalized << " does not exist\n";
         return false;
     }
 
-    // Prevent duplicate staging entries
-    std::unordered_set<std::string> stagedFiles;
-    {
-        std::ifstream staging(Constants::STAGING_FILE);
-        std::string line;
-        while (std::getline(staging, line)) {
-            if (!line.empty()) {
-                size_t pos = line.find(' ');
-                if (pos != std::string::npos) {
-                    std::string stagedFile = line.substr(0, pos);
-                    stagedFiles.insert(stagedFile);
-                }
-            }
-        }
+    if (std::filesystem::is_directory(normalized)) {
+        return addDirectory(normalized);
     }
-    if (stagedFiles.count(normalized)) {
-        // Already staged
-        return true;
+
+    if (!SparseCheckout::contains(normalized)) {
+        std::cerr << "Error: " << normalized << " is outside the sparse-checkout cone\n";
+        return false;
     }
 
-    std::string content = Utils::readFile(normalized);
+    ObjectView content = ObjectView::open(normalized);
     if (content.empty()) {
         std::cerr << "Warning: File " << normalized << " is empty or cannot be read\n";
     }
 
-    std::string hash = Utils::computeSHA1(content);
+    std::string hash = Utils::computeSHA1(content.view());
+
+    // Prevent duplicate staging entries (a staged removal is replaced)
+    auto staged = getStagedEntries();
+    auto entry = staged.find(normalized);
+    if (entry != staged.end() && entry->second == hash) {
+        // Already staged
+        return true;
+    }
 
     // Write blob object
-    if (!Utils::writeObject(hash, content)) {
+    if (!ChunkStore::writeBlob(hash, content.view())) {
         std::cerr << "Error: Failed to write object for file " << normalized << "\n";
         return false;
     }
@@ -77,6 +164,97 @@ bool FileAdder::addFile(const std::string& filename) {
     return true;
 }
 
+// Stage every change below a directory: files that differ from HEAD and
+// the staging area, and the removal of tracked files that are gone.
+// Unchanged files are known from the working-tree cache; new objects are
+// written on the worker pool and the staging file is appended to once.
+bool FileAdder::addDirectory(const std::string& directory) {
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+
+    std::string root = normalizePath(directory);
+    if (!SparseCheckout::containsDirectory(root)) {
+        std::cerr << "Error: " << root << " is outside the sparse-checkout cone\n";
+        return false;
+    }
+
+    // The stat cache says which files changed; only their blobs are read
+    std::vector<std::string> files;
+    std::vector<std::string> hashes;
+    const std::string prefix = root + "/";
+    const auto& working = WorkingTree::refresh(root);
+    for (auto it = root == "." ? working.begin() : working.lower_bound(prefix);
+         it != working.end() && (root == "." || it->first.compare(0, prefix.size(), prefix) == 0); ++it) {
+        files.push_back(it->first);
+        hashes.push_back(it->second.hash);
+    }
+    auto staged = getStagedEntries();
+    auto head = MergeManager::getCommitFiles(RefStore::resolveHead());
+
+    std::atomic<bool> failed{false};
+    Utils::parallelFor(files.size(), [&](size_t i) {
+        auto entry = staged.find(files[i]);
+        auto tracked = head.find(files[i]);
+        if (entry != staged.end() ? entry->second == hashes[i]
+                                  : tracked != head.end() && tracked->second == hashes[i]) {
+            hashes[i].clear();
+            return;
+        }
+        if (std::filesystem::exists(Utils::objectPath(hashes[i]))) return;
+
+        ObjectView content = ObjectView::open(files[i]);
+        if (!content.valid()) {
+            failed = true;
+            hashes[i].clear();
+            return;
+        }
+        hashes[i] = Utils::computeSHA1(content.view());  // it may have changed again since
+        if (!ChunkStore::writeBlob(hashes[i], content.view())) {
+            failed = true;
+            hashes[i].clear();
+        }
+    });
+
+    std::ofstream staging(Constants::STAGING_FILE, std::ios::app);
+    if (!staging) {
+        std::cerr << "Error: Could not open staging file\n";
+        return false;
+    }
+
+    size_t added = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (hashes[i].empty()) continue;
+        staging << files[i] << " " << hashes[i] << "\n";
+        ++added;
+    }
+
+    // Tracked (in-cone) files below root that no longer exist
+    std::unordered_set<std::string> present(files.begin(), files.end());
+    size_t removed = 0;
+    auto stageRemoval = [&](const std::string& path) {
+        if (root != "." && path.compare(0, prefix.size(), prefix) != 0) return;
+        if (present.count(path) || !SparseCheckout::contains(path)) return;
+        auto entry = staged.find(path);
+        if (entry != staged.end() && entry->second.empty()) return;
+        staging << path << " " << REMOVED << "\n";
+        ++removed;
+    };
+    for (const auto& entry : head) stageRemoval(entry.first);
+    for (const auto& entry : staged) {
+        if (!head.count(entry.first)) stageRemoval(entry.first);
+    }
+
+    if (failed) {
+        std::cerr << "Error: Some files under " << root << " could not be read or stored\n";
+    }
+    std::cout << "Added " << added << " file(s) from " << root;
+    if (removed) std::cout << ", removed " << removed;
+    std::cout << "\n";
+    return !failed;
+}
+
 std::vector<std::string> FileAdder::getStagedFiles() {
     std::vector<std::string> files;
     std::ifstream staging(Constants::STAGING_FILE);
@@ -92,5 +270,21 @@ std::vector<std::string> FileAdder::getStagedFiles() {
     return files;
 }
 
+// Staged paths mapped to their blob hashes (later entries win); a staged
+// removal maps to an empty hash
+std::unordered_map<std::string, std::string> FileAdder::getStagedEntries() {
+    std::unordered_map<std::string, std::string> entries;
+    std::ifstream staging(Constants::STAGING_FILE);
+    std::string line;
+    while (std::getline(staging, line)) {
+        size_t pos = line.find(' ');
+        if (pos != std::string::npos) {
+            std::string hash = line.substr(pos + 1);
+            entries[line.substr(0, pos)] = hash == REMOVED ? "" : hash;
+        }
+    }
+    return entries;
+}
+
 
 } // namespace MiniGit
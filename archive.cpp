@@ -0,0 +1,271 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <zlib.h>
+
+namespace MiniGit {
+
+namespace {
+    const size_t BLOCK = 512;
+    const size_t RECORD = 20 * BLOCK;                   // tar's default blocking factor
+    const size_t READ_AHEAD = 64;                       // entries prepared ahead of the writer
+    const size_t READ_AHEAD_BYTES = 64 * 1024 * 1024;   // bytes held by prepared entries
+    const size_t GZIP_BUFFER = 256 * 1024;
+
+    // Sink for the archive bytes: plain or gzip-compressed, to any stream
+    class ArchiveStream {
+    public:
+        ArchiveStream(std::ostream& out, bool gzip) : out(out), gzip(gzip) {
+            if (gzip) {
+                // windowBits 15 + 16 selects the gzip wrapper
+                deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+                buffer.resize(GZIP_BUFFER);
+            }
+        }
+        ~ArchiveStream() {
+            if (gzip) deflateEnd(&zs);
+        }
+
+        void write(const char* data, size_t size) {
+            written += size;
+            if (!gzip) {
+                out.write(data, static_cast<std::streamsize>(size));
+                return;
+            }
+            zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+            zs.avail_in = static_cast<uInt>(size);
+            pump(Z_NO_FLUSH);
+        }
+
+        bool finish() {
+            if (gzip) pump(Z_FINISH);
+            out.flush();
+            return static_cast<bool>(out);
+        }
+
+        size_t bytesWritten() const { return written; }
+
+    private:
+        void pump(int flush) {
+            do {
+                zs.next_out = reinterpret_cast<Bytef*>(&buffer[0]);
+                zs.avail_out = static_cast<uInt>(buffer.size());
+                deflate(&zs, flush);
+                out.write(buffer.data(), static_cast<std::streamsize>(buffer.size() - zs.avail_out));
+            } while (zs.avail_out == 0);
+        }
+
+        std::ostream& out;
+        bool gzip;
+        z_stream zs{};
+        std::string buffer;
+        size_t written = 0;
+    };
+
+    void putOctal(char* field, size_t width, uint64_t value) {
+        std::snprintf(field, width, "%0*llo", static_cast<int>(width - 1), static_cast<unsigned long long>(value));
+    }
+
+    // One pax record: "<length> <key>=<value>\n", where length counts itself
+    std::string paxRecord(const std::string& key, const std::string& value) {
+        size_t body = key.size() + value.size() + 3;
+        size_t length = body + std::to_string(body).size();
+        if (std::to_string(length).size() + body != length) ++length;
+        return std::to_string(length) + " " + key + "=" + value + "\n";
+    }
+
+    void writeHeader(ArchiveStream& out, const std::string& name, uint64_t size,
+                     std::time_t mtime, char type) {
+        char header[BLOCK];
+        std::memset(header, 0, BLOCK);
+        std::memcpy(header, name.data(), std::min<size_t>(name.size(), 100));
+        putOctal(header + 100, 8, 0644);
+        putOctal(header + 108, 8, 0);
+        putOctal(header + 116, 8, 0);
+        putOctal(header + 124, 12, size);
+        putOctal(header + 136, 12, static_cast<uint64_t>(mtime));
+        header[156] = type;
+        std::memcpy(header + 257, "ustar", 6);
+        std::memcpy(header + 263, "00", 2);
+
+        std::memset(header + 148, ' ', 8);
+        unsigned checksum = 0;
+        for (size_t i = 0; i < BLOCK; ++i) checksum += static_cast<unsigned char>(header[i]);
+        std::snprintf(header + 148, 8, "%06o", checksum);
+        out.write(header, BLOCK);
+    }
+
+    void writePadding(ArchiveStream& out, uint64_t size) {
+        static const char zeros[BLOCK] = {};
+        size_t pad = static_cast<size_t>((BLOCK - size % BLOCK) % BLOCK);
+        if (pad) out.write(zeros, pad);
+    }
+
+    // Paths over 100 bytes and sizes over 8 GiB go in a pax extended header
+    void writeEntryHeader(ArchiveStream& out, const std::string& path, uint64_t size, std::time_t mtime) {
+        const uint64_t maxOctalSize = 077777777777ULL;
+        std::string pax;
+        if (path.size() > 100) pax += paxRecord("path", path);
+        if (size > maxOctalSize) pax += paxRecord("size", std::to_string(size));
+        if (!pax.empty()) {
+            writeHeader(out, "PaxHeader", pax.size(), mtime, 'x');
+            out.write(pax.data(), pax.size());
+            writePadding(out, pax.size());
+        }
+        writeHeader(out, path.substr(0, 100), std::min(size, maxOctalSize), mtime, '0');
+    }
+
+    // A blob prepared by a reader thread; mapped pages are touched so the
+    // writer finds them resident
+    struct Prepared {
+        ObjectView object;
+        size_t charged = 0;
+        bool ready = false;
+    };
+}
+
+// Stream a tar of the commit's files. Reader threads open and fault in
+// blobs in manifest order up to READ_AHEAD entries (and READ_AHEAD_BYTES)
+// ahead of the single writer, so memory stays bounded whatever the size of
+// the tree; chunked blobs are copied one chunk at a time.
+bool Archiver::writeArchive(const std::string& revision, const std::string& outputPath, bool gzip) {
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+
+    std::string commitHash = RefStore::resolve(revision);
+    CommitInfo commit;
+    if (commitHash.empty() || !Utils::readCommit(commitHash, commit)) {
+        std::cerr << "Error: Unknown revision " << (revision.empty() ? "HEAD" : revision) << "\n";
+        return false;
+    }
+
+    std::unordered_map<std::string, std::string> files;
+    if (!MergeManager::getCommitFiles(commitHash, files)) {
+        std::cerr << "Error: Could not read the manifest of " << commitHash << "\n";
+        return false;
+    }
+    std::map<std::string, std::string> manifest;
+    for (auto& entry : files) manifest.emplace(entry.first, std::move(entry.second));
+
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Error: Could not open " << outputPath << "\n";
+            return false;
+        }
+    }
+    std::ostream& sink = outputPath.empty() ? std::cout : file;
+
+    std::vector<std::pair<std::string, std::string>> entries(manifest.begin(), manifest.end());
+
+    std::vector<Prepared> slots(entries.size());
+    std::mutex mutex;
+    std::condition_variable changed;
+    ByteBudget budget(READ_AHEAD_BYTES);
+    size_t writtenEntries = 0;
+    size_t admitTurn = 0;  // budget is taken strictly in entry order
+    std::atomic<size_t> next{0};
+
+    auto reader = [&] {
+        for (size_t i = next++; i < entries.size(); i = next++) {
+            std::error_code ec;
+            size_t size = static_cast<size_t>(std::filesystem::file_size(Utils::objectPath(entries[i].second), ec));
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return admitTurn == i && i < writtenEntries + READ_AHEAD; });
+            }
+            budget.acquire(size);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++admitTurn;
+            }
+            changed.notify_all();
+
+            ObjectView object = Utils::readObject(entries[i].second);
+            volatile char sum = 0;
+            for (size_t offset = 0; offset < object.size(); offset += 4096) sum = sum + object.data()[offset];
+
+            std::lock_guard<std::mutex> lock(mutex);
+            slots[i].object = std::move(object);
+            slots[i].charged = size;
+            slots[i].ready = true;
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> readers;
+    for (unsigned t = 0; t < std::max(1u, Utils::workerCount()); ++t) readers.emplace_back(reader);
+
+    ArchiveStream out(sink, gzip);
+    bool success = true;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        Prepared prepared;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return slots[i].ready; });
+            prepared = std::move(slots[i]);
+        }
+
+        const std::string& path = entries[i].first;
+        std::string_view data = prepared.object.view();
+        if (!prepared.object.valid()) {
+            std::cerr << "Error: Missing blob " << entries[i].second << " for " << path << "\n";
+            success = false;
+        } else if (ChunkStore::isChunkList(data)) {
+            auto chunks = ChunkStore::chunksOf(data);
+            uint64_t size = 0;
+            for (const auto& chunk : chunks) size += chunk.size;
+            writeEntryHeader(out, path, size, commit.time);
+            for (const auto& chunk : chunks) {
+                ObjectView piece = Utils::readObject(chunk.hash);
+                if (piece.size() != chunk.size) {
+                    std::cerr << "Error: Damaged chunk " << chunk.hash << " in " << path << "\n";
+                    success = false;
+                    std::string zeros(chunk.size, '\0');  // keep the archive well-formed
+                    out.write(zeros.data(), zeros.size());
+                    continue;
+                }
+                out.write(piece.data(), piece.size());
+            }
+            writePadding(out, size);
+        } else {
+            writeEntryHeader(out, path, data.size(), commit.time);
+            out.write(data.data(), data.size());
+            writePadding(out, data.size());
+        }
+
+        prepared.object = ObjectView();
+        budget.release(prepared.charged);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++writtenEntries;
+        }
+        changed.notify_all();
+    }
+    for (auto& thread : readers) thread.join();
+
+    // End of archive: two zero blocks, padded to a whole record
+    static const char zeros[BLOCK] = {};
+    out.write(zeros, BLOCK);
+    out.write(zeros, BLOCK);
+    while (out.bytesWritten() % RECORD) out.write(zeros, BLOCK);
+
+    if (!out.finish()) {
+        std::cerr << "Error: Failed to write archive\n";
+        return false;
+    }
+    if (!outputPath.empty()) {
+        std::cerr << "Wrote " << entries.size() << " file(s) from " << commitHash.substr(0, 7)
+                  << " to " << outputPath << "\n";
+    }
+    return success;
+}
+
+} // namespace MiniGit
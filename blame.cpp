@@ -0,0 +1,259 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <queue>
+#include <memory>
+
+namespace MiniGit {
+
+namespace {
+    // Give up on a full diff beyond this many edits; only the common prefix
+    // and suffix are then carried over to the parent
+    const int MAX_DIFF_EDITS = 4096;
+
+    // A blob split into lines, each interned to an id so diffs compare ints
+    struct BlobLines {
+        ObjectView object;
+        std::string reassembled;  // content of a chunked blob
+        std::vector<std::string_view> lines;
+        std::vector<uint32_t> ids;
+    };
+
+    struct BlameCache {
+        std::unordered_map<std::string_view, uint32_t> internTable;
+        std::unordered_map<std::string, std::unique_ptr<BlobLines>> blobs;
+        std::unordered_map<std::string, std::vector<int>> diffs;     // "from:to" -> line map
+        std::unordered_map<std::string, std::string> manifestBlobs;  // commit -> blob of path
+        std::string damaged;  // a chunked blob that could not be reassembled
+    };
+
+    const BlobLines& linesOf(BlameCache& cache, const std::string& blobHash) {
+        auto& slot = cache.blobs[blobHash];
+        if (slot) return *slot;
+
+        slot = std::make_unique<BlobLines>();
+        slot->object = Utils::readObject(blobHash);
+        std::string_view content = slot->object.view();
+        if (ChunkStore::isChunkList(content)) {
+            if (!ChunkStore::readContent(content, slot->reassembled)) cache.damaged = blobHash;
+            content = slot->reassembled;
+        }
+        while (!content.empty()) {
+            size_t eol = content.find('\n');
+            std::string_view line = content.substr(0, eol);
+            content = eol == std::string_view::npos ? std::string_view() : content.substr(eol + 1);
+
+            auto id = cache.internTable.emplace(line, static_cast<uint32_t>(cache.internTable.size()));
+            slot->lines.push_back(line);
+            slot->ids.push_back(id.first->second);
+        }
+        return *slot;
+    }
+
+    // Myers O(ND) diff. Returns, for each line of b, the matching line of a
+    // or -1 when the line was introduced by b.
+    std::vector<int> diffLines(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+        std::vector<int> match(b.size(), -1);
+
+        int prefix = 0;
+        while (prefix < static_cast<int>(std::min(a.size(), b.size())) && a[prefix] == b[prefix]) {
+            match[prefix] = prefix;
+            ++prefix;
+        }
+        int suffix = 0;
+        while (suffix < static_cast<int>(std::min(a.size(), b.size())) - prefix &&
+               a[a.size() - 1 - suffix] == b[b.size() - 1 - suffix]) {
+            match[b.size() - 1 - suffix] = static_cast<int>(a.size() - 1 - suffix);
+            ++suffix;
+        }
+
+        const uint32_t* x0 = a.data() + prefix;
+        const uint32_t* y0 = b.data() + prefix;
+        int n = static_cast<int>(a.size()) - prefix - suffix;
+        int m = static_cast<int>(b.size()) - prefix - suffix;
+        if (n == 0 || m == 0) return match;
+
+        // trace[d] holds V after step d for diagonals -d..d
+        int max = n + m;
+        int offset = max + 1;
+        std::vector<int> v(2 * max + 3, 0);
+        std::vector<std::vector<int>> trace;
+        int editDistance = -1;
+
+        for (int d = 0; d <= max && d <= MAX_DIFF_EDITS && editDistance < 0; ++d) {
+            for (int k = -d; k <= d; k += 2) {
+                bool down = k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1]);
+                int x = down ? v[offset + k + 1] : v[offset + k - 1] + 1;
+                int y = x - k;
+                while (x < n && y < m && x0[x] == y0[y]) {
+                    ++x;
+                    ++y;
+                }
+                v[offset + k] = x;
+                if (x >= n && y >= m) editDistance = d;
+            }
+            trace.emplace_back(v.begin() + offset - d, v.begin() + offset + d + 1);
+        }
+        if (editDistance < 0) return match;
+
+        int x = n, y = m;
+        for (int d = editDistance; d > 0; --d) {
+            const std::vector<int>& prev = trace[d - 1];
+            auto at = [&](int k) { return prev[k + d - 1]; };
+            int k = x - y;
+            bool down = k == -d || (k != d && at(k - 1) < at(k + 1));
+            int prevK = down ? k + 1 : k - 1;
+            int prevX = at(prevK);
+            int startX = down ? prevX : prevX + 1;
+            while (x > startX) {
+                --x;
+                --y;
+                match[prefix + y] = prefix + x;
+            }
+            x = prevX;
+            y = prevX - prevK;
+        }
+        while (x > 0 && y > 0) {
+            --x;
+            --y;
+            match[prefix + y] = prefix + x;
+        }
+        return match;
+    }
+
+    const std::vector<int>& cachedDiff(BlameCache& cache, const std::string& from, const std::string& to) {
+        std::string key = from + ":" + to;
+        auto it = cache.diffs.find(key);
+        if (it != cache.diffs.end()) return it->second;
+        return cache.diffs[key] = diffLines(linesOf(cache, from).ids, linesOf(cache, to).ids);
+    }
+
+    std::string blobAt(BlameCache& cache, const std::string& commitHash, const std::string& path) {
+        auto it = cache.manifestBlobs.find(commitHash);
+        if (it != cache.manifestBlobs.end()) return it->second;
+        return cache.manifestBlobs[commitHash] = MergeManager::getCommitFile(commitHash, path);
+    }
+
+    // Lines still looking for an owner in one commit's version of the file
+    struct Pending {
+        std::string blob;
+        std::vector<std::pair<int, int>> lines;  // line in this version, final line
+    };
+}
+
+// Attribute each line of path at HEAD to the commit that introduced it.
+// Commits are visited in generation order so every child hands its lines to
+// a parent before that parent is processed; unchanged blobs pass straight
+// through, and only real content changes are diffed.
+bool Blamer::blameFile(const std::string& path) {
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+
+    std::string head = RefStore::resolveHead();
+    BlameCache cache;
+    std::string headBlob = head.empty() ? "" : blobAt(cache, head, path);
+    if (headBlob.empty()) {
+        std::cerr << "Error: " << path << " is not tracked in HEAD\n";
+        return false;
+    }
+
+    const BlobLines& finalLines = linesOf(cache, headBlob);
+    std::vector<std::string> owner(finalLines.lines.size());
+
+    std::unordered_map<std::string, Pending> pending;
+    auto byGeneration = [](const std::pair<uint32_t, std::string>& a,
+                           const std::pair<uint32_t, std::string>& b) { return a.first < b.first; };
+    std::priority_queue<std::pair<uint32_t, std::string>,
+                        std::vector<std::pair<uint32_t, std::string>>,
+                        decltype(byGeneration)> queue(byGeneration);
+
+    // Queue lines for a parent; false (lines untouched) if it is missing
+    auto handOff = [&](const std::string& commitHash, const std::string& blob,
+                       std::vector<std::pair<int, int>>& lines) {
+        const CommitGraph::Entry* entry = CommitGraph::lookup(commitHash);
+        if (!entry) return false;
+        auto [slot, inserted] = pending.try_emplace(commitHash);
+        if (inserted) {
+            slot->second.blob = blob;
+            queue.emplace(entry->generation, commitHash);
+        }
+        auto& target = slot->second.lines;
+        target.insert(target.end(), lines.begin(), lines.end());
+        lines.clear();
+        return true;
+    };
+
+    std::vector<std::pair<int, int>> initial;
+    for (int i = 0; i < static_cast<int>(finalLines.lines.size()); ++i) initial.emplace_back(i, i);
+    handOff(head, headBlob, initial);
+
+    while (!queue.empty()) {
+        std::string commitHash = queue.top().second;
+        queue.pop();
+        auto node = pending.extract(commitHash);
+        Pending& work = node.mapped();
+        const CommitGraph::Entry* entry = CommitGraph::lookup(commitHash);
+
+        for (size_t p = 0; p < entry->parents.size() && !work.lines.empty(); ++p) {
+            const std::string& parent = entry->parents[p];
+
+            // The filter proves the file is identical in the first parent
+            if (p == 0 && !CommitGraph::mayChangePath(*entry, path)) {
+                cache.manifestBlobs.emplace(parent, work.blob);
+                handOff(parent, work.blob, work.lines);
+                break;
+            }
+
+            std::string parentBlob = blobAt(cache, parent, path);
+            if (parentBlob.empty()) continue;
+
+            if (parentBlob == work.blob) {
+                handOff(parent, parentBlob, work.lines);
+                break;
+            }
+
+            const std::vector<int>& match = cachedDiff(cache, parentBlob, work.blob);
+            std::vector<std::pair<int, int>> moved, kept;
+            for (const auto& [line, finalLine] : work.lines) {
+                if (match[line] >= 0) {
+                    moved.emplace_back(match[line], finalLine);
+                } else {
+                    kept.emplace_back(line, finalLine);
+                }
+            }
+            if (!handOff(parent, parentBlob, moved)) continue;
+            work.lines = std::move(kept);
+        }
+
+        for (const auto& line : work.lines) {
+            owner[line.second] = commitHash;
+        }
+    }
+    CommitGraph::save();
+    if (!cache.damaged.empty()) {
+        std::cerr << "Error: Missing or damaged chunk in blob " << cache.damaged << "\n";
+        return false;
+    }
+
+    std::string out;
+    int width = static_cast<int>(std::to_string(owner.size()).size());
+    for (size_t i = 0; i < owner.size(); ++i) {
+        const CommitGraph::Entry* entry = CommitGraph::lookup(owner[i]);
+        std::time_t time = entry ? entry->time : 0;
+        char timeStr[32];
+        std::strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", std::localtime(&time));
+
+        std::ostringstream line;
+        line << owner[i].substr(0, 8) << " (" << timeStr << " "
+             << std::setw(width) << (i + 1) << ") " << finalLines.lines[i] << "\n";
+        out += line.str();
+    }
+    std::cout << out;
+    return true;
+}
+
+} // namespace MiniGit
@@ -9,20 +9,14 @@ namespace MiniGit {
 
 bool BranchManager::branchExists(const std::string& branchName) {
     if (branchName.empty()) return false;
-    std::string branchPath = Constants::GIT_DIR + "/refs/heads/" + branchName;
-    return std::filesystem::exists(branchPath);
+    return !RefStore::readRef("refs/heads/" + branchName).empty();
 }
 
 std::vector<std::string> BranchManager::listBranches() {
     std::vector<std::string> branches;
-    std::ifstream file(Constants::BRANCHES_FILE);
-    if (file.is_open()) {
-        std::string line;
-        while (std::getline(file, line)) {
-            if (!line.empty()) {
-                branches.push_back(line);
-            }
-        }
+    const std::string prefix = "refs/heads/";
+    for (const auto& ref : RefStore::listRefs(prefix)) {
+        branches.push_back(ref.first.substr(prefix.size()));
     }
     return branches;
 }
@@ -40,13 +34,6 @@ std::string BranchManager::getCurrentBranch() {
 }
 
 namespace {
-    void AddBranchToFile(const std::string& branchName) {
-        std::ofstream branches(Constants::BRANCHES_FILE, std::ios::app);
-        if (branches) {
-            branches << branchName << "\n";
-        }
-    }
-    
     std::string CreateInitialCommit() {
         std::string hash = Utils::generateHash();
         std::string content = "message Initial commit\n";
@@ -68,34 +55,46 @@ bool BranchManager::createBranch(const std::string& branchName) {
     }
 
     std::string currentBranch = getCurrentBranch();
-    std::string currentCommit = Utils::readFile(
-        Constants::GIT_DIR + "/refs/heads/" + currentBranch
-    );
+    std::string currentCommit = RefStore::resolveHead();
 
     if (currentCommit.empty()) {
         currentCommit = CreateInitialCommit();
-        if (!Utils::writeFile(
-            Constants::GIT_DIR + "/refs/heads/" + currentBranch,
-            currentCommit
-        )) {
+        if (!RefStore::writeRef("refs/heads/" + currentBranch, currentCommit)) {
             std::cerr << "Failed to initialize branch\n";
             return false;
         }
     }
 
-    if (!Utils::writeFile(
-        Constants::GIT_DIR + "/refs/heads/" + branchName,
-        currentCommit
-    )) {
+    if (!RefStore::writeRef("refs/heads/" + branchName, currentCommit)) {
         std::cerr << "Failed to create branch " << branchName << "\n";
         return false;
     }
 
-    AddBranchToFile(branchName);
     std::cout << "Created branch " << branchName << " from " << currentBranch << "\n";
     return true;
 }
 
+bool BranchManager::deleteBranch(const std::string& branchName) {
+    if (!branchExists(branchName)) {
+        std::cerr << "Branch " << branchName << " does not exist\n";
+        return false;
+    }
+
+    if (branchName == getCurrentBranch()) {
+        std::cerr << "Cannot delete the checked-out branch " << branchName << "\n";
+        return false;
+    }
+
+    std::string commitHash = RefStore::readRef("refs/heads/" + branchName);
+    if (!RefStore::deleteRef("refs/heads/" + branchName)) {
+        std::cerr << "Failed to delete branch " << branchName << "\n";
+        return false;
+    }
+
+    std::cout << "Deleted branch " << branchName << " (was " << commitHash.substr(0, 7) << ")\n";
+    return true;
+}
+
 bool BranchManager::checkoutBranch(const std::string& branchName) {
     if (branchName.empty()) {
         std::cerr << "Branch name cannot be empty\n";
@@ -104,12 +103,11 @@ bool BranchManager::checkoutBranch(const std::string& branchName) {
 
     if (branchName == "main" && !branchExists("main")) {
         std::string initialCommit = CreateInitialCommit();
-        if (!Utils::writeFile(Constants::GIT_DIR + "/refs/heads/main", initialCommit) ||
+        if (!RefStore::writeRef("refs/heads/main", initialCommit) ||
             !Utils::writeFile(Constants::HEAD_FILE, "ref: refs/heads/main")) {
             std::cerr << "Failed to create main branch\n";
             return false;
         }
-        AddBranchToFile("main");
         std::cout << "Created and switched to 'main' branch\n";
         return true;
     }
@@ -119,9 +117,7 @@ bool BranchManager::checkoutBranch(const std::string& branchName) {
         return false;
     }
 
-    std::string commitHash = Utils::readFile(
-        Constants::GIT_DIR + "/refs/heads/" + branchName
-    );
+    std::string commitHash = RefStore::readRef("refs/heads/" + branchName);
 
     return CheckoutManager::checkoutCommit(commitHash, branchName);
 }
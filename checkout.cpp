@@ -3,12 +3,29 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <set>
+#include <mutex>
 
 namespace MiniGit {
 
+namespace {
+    // Upper bound on blob bytes being written concurrently during checkout
+    const size_t CHECKOUT_BYTE_BUDGET = 64 * 1024 * 1024;
+}
+
 bool CheckoutManager::checkoutCommit(const std::string& commitHash, const std::string& branchName) {
     namespace fs = std::filesystem;
 
+    // Files of the commit being left (any not in the target are removed
+    // below) and of the target. Both must be complete: a partial list would
+    // delete tracked files or leave stale ones behind.
+    std::unordered_map<std::string, std::string> previousFiles, targetFiles;
+    if (!MergeManager::getCommitFiles(RefStore::resolveHead(), previousFiles) ||
+        !MergeManager::getCommitFiles(commitHash, targetFiles)) {
+        std::cerr << "Error: Could not read the manifest of the current or target commit\n";
+        return false;
+    }
+
     // Update HEAD properly depending on branch or detached HEAD
     if (branchName.empty()) {
         // Detached HEAD — write commit hash directly
@@ -25,48 +42,40 @@ bool CheckoutManager::checkoutCommit(const std::string& commitHash, const std::s
     }
 
     // Get list of files that should exist in target commit
-    std::vector<std::string> commitFiles;
-    if (!commitHash.empty()) {
-        std::string commitPath = Constants::GIT_DIR + "/objects/" + 
-                               commitHash.substr(0, 2) + "/" + 
-                               commitHash.substr(2);
-        std::string content = Utils::readFile(commitPath);
-        std::istringstream iss(content);
-        std::string line;
-        
-        while (std::getline(iss, line)) {
-            if (line.substr(0, 5) == "file ") {
-                size_t space = line.find(' ', 5);
-                if (space != std::string::npos) {
-                    commitFiles.push_back(line.substr(5, space - 5));
-                }
-            }
-        }
+    std::vector<std::pair<std::string, std::string>> commitFiles;
+    for (auto& [filename, blobHash] : targetFiles) {
+        // Paths outside the sparse cones are neither written nor kept
+        if (!SparseCheckout::contains(filename)) continue;
+        commitFiles.emplace_back(filename, std::move(blobHash));
     }
 
-    // Clean working directory (remove files not in target commit)
-    try {
-        for (const auto& entry : fs::directory_iterator(".")) {
-            const auto& path = entry.path();
-            std::string filename = path.filename().string();
-            
-            // Skip repository and development files
-            if (filename == Constants::GIT_DIR || 
-                filename == ".git" ||
-                filename == "minigit.exe" ||
-                path.extension() == ".cpp" || 
-                path.extension() == ".hpp" ||
-                filename == ".gitignore") {
-                continue;
-            }
-            
-            // Remove if not in target commit
-            if (std::find(commitFiles.begin(), commitFiles.end(), filename) == commitFiles.end()) {
-                fs::remove_all(path);
-            }
+    // Clean working directory (remove files not in target commit). The
+    // working-tree cache lists what is on disk without walking the tree.
+    const auto& working = WorkingTree::refresh();
+    std::unordered_map<std::string, std::string> target(commitFiles.begin(), commitFiles.end());
+    std::set<std::string> doomed;
+    for (const auto& [path, entry] : working) {
+        if (!target.count(path)) doomed.insert(path);
+    }
+    for (const auto& [path, hash] : previousFiles) {
+        if (!target.count(path)) doomed.insert(path);
+    }
+    for (const auto& path : doomed) {
+        // Skip repository and development files at the top level
+        fs::path file(path);
+        std::string filename = file.filename().string();
+        if (path.find('/') == std::string::npos &&
+            (filename == "minigit.exe" || file.extension() == ".cpp" || file.extension() == ".hpp" ||
+             filename == ".gitignore" || filename == Constants::IGNORE_FILE)) {
+            continue;
+        }
+        std::error_code ec;
+        if (!fs::is_regular_file(fs::symlink_status(file, ec)) || !fs::remove(file, ec)) continue;
+
+        // Drop directories the removal left empty
+        for (fs::path dir = file.parent_path(); !dir.empty(); dir = dir.parent_path()) {
+            if (!fs::is_empty(dir, ec) || ec || !fs::remove(dir, ec)) break;
         }
-    } catch (const std::exception& e) {
-        std::cerr << "Warning: Could not clean working directory - " << e.what() << "\n";
     }
 
     // Restore files from commit
@@ -75,44 +84,72 @@ bool CheckoutManager::checkoutCommit(const std::string& commitHash, const std::s
         return true;
     }
 
-    std::string commitPath = Constants::GIT_DIR + "/objects/" + 
-                           commitHash.substr(0, 2) + "/" + 
-                           commitHash.substr(2);
-    std::string content = Utils::readFile(commitPath);
-    std::istringstream iss(content);
-    std::string line;
+    // Create every parent directory once, up front, so writers never race
+    // on (or repeatedly stat) the same directories
+    std::set<fs::path> directories;
+    for (const auto& file : commitFiles) {
+        fs::path parent = fs::path(file.first).parent_path();
+        if (!parent.empty()) directories.insert(parent);
+    }
+    for (const auto& dir : directories) {
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        if (ec) {
+            std::cerr << "Warning: Could not create directory " << dir.generic_string()
+                      << " - " << ec.message() << "\n";
+        }
+    }
+
+    // Stream blob writes across the worker pool within a bounded byte budget
+    std::mutex reportMutex;
     bool success = true;
+    ByteBudget budget(CHECKOUT_BYTE_BUDGET);
 
-    while (std::getline(iss, line)) {
-        if (line.substr(0, 5) == "file ") {
-            size_t space = line.find(' ', 5);
-            if (space == std::string::npos) continue;
-
-            std::string filename = line.substr(5, space - 5);
-            std::string blobHash = line.substr(space + 1);
-
-            try {
-                std::string blobPath = Constants::GIT_DIR + "/objects/" + 
-                                     blobHash.substr(0, 2) + "/" + 
-                                     blobHash.substr(2);
-                std::string fileContent = Utils::readFile(blobPath);
-                
-                fs::path parent = fs::path(filename).parent_path();
-                if (!parent.empty()) {
-                    fs::create_directories(parent);
-                }
-
-                if (!Utils::writeFile(filename, fileContent)) {
-                    std::cerr << "Warning: Failed to write file " << filename << "\n";
-                    success = false;
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "Error restoring file " << filename 
-                          << ": " << e.what() << "\n";
+    std::vector<char> written(commitFiles.size(), 0);
+    Utils::parallelFor(commitFiles.size(), [&](size_t i) {
+        const auto& [filename, blobHash] = commitFiles[i];
+
+        // Files already holding the right content are left alone
+        auto current = working.find(filename);
+        if (current != working.end() && current->second.hash == blobHash) return;
+
+        // Charge the object's size before it is read or mapped, so the
+        // budget bounds the bytes actually held by workers
+        std::error_code sizeError;
+        uintmax_t onDisk = fs::file_size(Utils::objectPath(blobHash), sizeError);
+        size_t charge = sizeError ? 0 : static_cast<size_t>(onDisk);
+        budget.acquire(charge);
+        try {
+            // Write straight from the mapped object; no intermediate string.
+            // Chunked blobs stream one chunk at a time.
+            ObjectView blob = Utils::readObject(blobHash);
+            bool ok;
+            if (ChunkStore::isChunkList(blob.view())) {
+                ok = ChunkStore::writeFile(filename, blob.view());
+            } else {
+                ok = Utils::writeFile(filename, blob.view());
+            }
+
+            if (ok) {
+                written[i] = 1;
+            } else {
+                std::lock_guard<std::mutex> lock(reportMutex);
+                std::cerr << "Warning: Failed to write file " << filename << "\n";
                 success = false;
             }
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(reportMutex);
+            std::cerr << "Error restoring file " << filename 
+                      << ": " << e.what() << "\n";
+            success = false;
         }
+        budget.release(charge);
+    });
+
+    for (size_t i = 0; i < commitFiles.size(); ++i) {
+        if (written[i]) WorkingTree::record(commitFiles[i].first, commitFiles[i].second);
     }
+    WorkingTree::save();
 
     if (success) {
         if (branchName.empty()) {
@@ -0,0 +1,167 @@
+#include "minigit.hpp"
+#include <openssl/evp.h>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <array>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+namespace MiniGit {
+
+namespace {
+    // The leading NUL keeps a chunk list from being mistaken for a text file
+    const std::string CHUNK_LIST_HEADER = std::string("\0MINIGIT-CHUNKS 1\n", 18);
+
+    // FastCDC parameters: no cut before MIN, a harder mask before AVG and an
+    // easier one after it (normalized chunking), and a forced cut at MAX
+    const size_t MIN_CHUNK = 16 * 1024;
+    const size_t AVG_CHUNK = 64 * 1024;
+    const size_t MAX_CHUNK = 256 * 1024;
+    const uint64_t MASK_SMALL = 0xFFFFC00000000000ULL;  // 18 bits: cuts rarer below AVG
+    const uint64_t MASK_LARGE = 0xFFFC000000000000ULL;  // 14 bits: cuts likelier above AVG
+
+    // Gear table from a fixed splitmix64 sequence, so boundaries are stable
+    // across builds and machines
+    const std::array<uint64_t, 256>& gearTable() {
+        static const std::array<uint64_t, 256> table = [] {
+            std::array<uint64_t, 256> gear{};
+            uint64_t state = 0x6d696e6967697400ULL;
+            for (auto& value : gear) {
+                uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                value = z ^ (z >> 31);
+            }
+            return gear;
+        }();
+        return table;
+    }
+
+    // Length of the next chunk at the start of data
+    size_t nextCut(std::string_view data) {
+        if (data.size() <= MIN_CHUNK) return data.size();
+        const auto& gear = gearTable();
+        size_t limit = std::min(data.size(), MAX_CHUNK);
+        size_t normal = std::min(limit, AVG_CHUNK);
+
+        uint64_t fingerprint = 0;
+        size_t i = MIN_CHUNK;
+        for (; i < normal; ++i) {
+            fingerprint = (fingerprint << 1) + gear[static_cast<unsigned char>(data[i])];
+            if (!(fingerprint & MASK_SMALL)) return i + 1;
+        }
+        for (; i < limit; ++i) {
+            fingerprint = (fingerprint << 1) + gear[static_cast<unsigned char>(data[i])];
+            if (!(fingerprint & MASK_LARGE)) return i + 1;
+        }
+        return limit;
+    }
+}
+
+// Store a blob under hash, splitting it into chunks above the threshold.
+// Chunks already in the store (from earlier revisions) are not rewritten.
+bool ChunkStore::writeBlob(const std::string& hash, std::string_view content) {
+    if (content.size() < CHUNK_THRESHOLD) {
+        return Utils::writeObject(hash, content);
+    }
+
+    std::string list = CHUNK_LIST_HEADER;
+    while (!content.empty()) {
+        std::string_view chunk = content.substr(0, nextCut(content));
+        content.remove_prefix(chunk.size());
+
+        std::string chunkHash = Utils::computeSHA1(chunk);
+        if (!std::filesystem::exists(Utils::objectPath(chunkHash)) &&
+            !Utils::writeObject(chunkHash, chunk)) {
+            return false;
+        }
+        list += chunkHash + " " + std::to_string(chunk.size()) + "\n";
+    }
+    return Utils::writeObject(hash, list);
+}
+
+bool ChunkStore::isChunkList(std::string_view object) {
+    return object.substr(0, CHUNK_LIST_HEADER.size()) == CHUNK_LIST_HEADER;
+}
+
+// Checks only the header, without reading the rest of the object
+bool ChunkStore::isChunked(const std::string& hash) {
+    if (hash.length() != 40) return false;
+    std::ifstream file(Utils::objectPath(hash), std::ios::binary);
+    std::string header(CHUNK_LIST_HEADER.size(), '\0');
+    if (!file.read(&header[0], static_cast<std::streamsize>(header.size()))) return false;
+    return header == CHUNK_LIST_HEADER;
+}
+
+std::vector<ChunkStore::Chunk> ChunkStore::chunksOf(std::string_view object) {
+    std::vector<Chunk> chunks;
+    if (!isChunkList(object)) return chunks;
+    object.remove_prefix(CHUNK_LIST_HEADER.size());
+    while (!object.empty()) {
+        size_t eol = object.find('\n');
+        std::string_view line = object.substr(0, eol);
+        object = eol == std::string_view::npos ? std::string_view() : object.substr(eol + 1);
+        if (line.size() < 42) continue;
+        chunks.push_back({std::string(line.substr(0, 40)),
+                          static_cast<size_t>(std::strtoull(std::string(line.substr(41)).c_str(), nullptr, 10))});
+    }
+    return chunks;
+}
+
+// Write a chunked blob to path one mapped chunk at a time
+bool ChunkStore::writeFile(const std::string& path, std::string_view object) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    for (const auto& chunk : chunksOf(object)) {
+        ObjectView data = Utils::readObject(chunk.hash);
+        if (!data.valid() || data.size() != chunk.size) return false;
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+    return static_cast<bool>(file);
+}
+
+// Reassemble a chunked blob in memory; false (content cleared) if a chunk
+// is missing or the wrong size
+bool ChunkStore::readContent(std::string_view object, std::string& content) {
+    std::vector<Chunk> chunks = chunksOf(object);
+    size_t total = 0;
+    for (const auto& chunk : chunks) total += chunk.size;
+
+    content.clear();
+    content.reserve(total);
+    for (const auto& chunk : chunks) {
+        ObjectView data = Utils::readObject(chunk.hash);
+        if (!data.valid() || data.size() != chunk.size) {
+            content.clear();
+            return false;
+        }
+        content.append(data.data(), data.size());
+    }
+    return true;
+}
+
+// SHA-1 of the reassembled content, streamed over the chunks; empty if a
+// chunk is missing
+std::string ChunkStore::contentHash(std::string_view object) {
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> context(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    if (!context || !EVP_DigestInit_ex(context.get(), EVP_sha1(), nullptr)) return "";
+
+    for (const auto& chunk : chunksOf(object)) {
+        ObjectView data = Utils::readObject(chunk.hash);
+        if (!data.valid() || data.size() != chunk.size) return "";
+        EVP_DigestUpdate(context.get(), data.data(), data.size());
+    }
+
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_DigestFinal_ex(context.get(), digest, &length);
+    std::ostringstream oss;
+    for (unsigned int i = 0; i < length; i++) {
+        oss << std::hex << std::setw(2) << std::setfill('0') << (int)digest[i];
+    }
+    return oss.str();
+}
+
+} // namespace MiniGit
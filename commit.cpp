@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <sstream>
 #include <ctime>
+#include <algorithm>
 
 namespace MiniGit {
 
@@ -14,22 +15,8 @@ bool Committer::commitChanges(const std::string& message) {
     }
 
          
-    // Read staged files
-    std::unordered_map<std::string, std::string> stagedFiles;
-    std::ifstream staging(Constants::STAGING_FILE);
-    if (!staging) {
-        std::cerr << "Error: Could not open staging area\n";
-        return false;
-    }
-
-    std::string line;
-    while (std::getline(staging, line)) {
-        size_t sep = line.find(' ');
-        if (sep != std::string::npos) {
-            stagedFiles[line.substr(0, sep)] = line.substr(sep + 1);
-        }
-    }
-
+    // Staged changes; an empty hash is a staged removal
+    std::unordered_map<std::string, std::string> stagedFiles = FileAdder::getStagedEntries();
     if (stagedFiles.empty()) {
         std::cerr << "No changes staged for commit\n";
         return false;
@@ -37,20 +24,22 @@ bool Committer::commitChanges(const std::string& message) {
 
     // Get parent commit
     std::string currentBranch = BranchManager::getCurrentBranch();
-    std::string parentCommit = Utils::readFile(
-        Constants::GIT_DIR + "/refs/heads/" + currentBranch
-    );
+    std::string parentCommit = RefStore::readRef("refs/heads/" + currentBranch);
+
+    // The snapshot is the parent's manifest with the staged changes applied
+    std::string root = Manifest::updateCommit(parentCommit, stagedFiles);
+    if (root.empty()) {
+        std::cerr << "Error: Could not build manifest from parent commit " << parentCommit << "\n";
+        return false;
+    }
 
     // Create commit object
     std::ostringstream commitContent;
     commitContent << "message " << message << "\n"
                  << "time " << std::time(nullptr) << "\n"
                  << "parent " << parentCommit << "\n"
-                 << "branch " << currentBranch << "\n";
-    
-    for (const auto& [file, hash] : stagedFiles) {
-        commitContent << "file " << file << " " << hash << "\n";
-    }
+                 << "branch " << currentBranch << "\n"
+                 << "manifest " << root << "\n";
 
     // Store commit
     std::string content = commitContent.str();
@@ -61,20 +50,25 @@ bool Committer::commitChanges(const std::string& message) {
     }
 
     // Update branch reference
-    if (!Utils::writeFile(
-        Constants::GIT_DIR + "/refs/heads/" + currentBranch,
-        commitHash
-    )) {
+    if (!RefStore::writeRef("refs/heads/" + currentBranch, commitHash)) {
         std::cerr << "Error updating branch reference\n";
         return false;
     }
 
+    // Record graph data (parents, changed-path filter) for fast history walks
+    CommitGraph::lookup(commitHash);
+    CommitGraph::save();
+
     // Clear staging
     std::ofstream(Constants::STAGING_FILE, std::ios::trunc).close();
 
+    size_t removed = std::count_if(stagedFiles.begin(), stagedFiles.end(),
+                                   [](const auto& entry) { return entry.second.empty(); });
     std::cout << "[" << commitHash.substr(0, 7) << "] " 
               << currentBranch << ": " << message << "\n"
-              << " " << stagedFiles.size() << " file(s) committed\n";
+              << " " << stagedFiles.size() - removed << " file(s) committed";
+    if (removed) std::cout << ", " << removed << " removed";
+    std::cout << "\n";
     
     return true;
 }
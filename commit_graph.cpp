@@ -0,0 +1,263 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <unordered_set>
+
+namespace MiniGit {
+
+namespace {
+    const size_t BLOOM_BITS_PER_PATH = 10;
+    const size_t BLOOM_HASHES = 7;
+    const size_t BLOOM_MAX_PATHS = 512;  // beyond this, store "changed everything"
+
+    struct GraphState {
+        bool loaded = false;
+        std::unordered_map<std::string, CommitGraph::Entry> entries;
+        std::vector<std::string> pendingLines;
+    };
+
+    GraphState& graphState() {
+        static GraphState state;
+        return state;
+    }
+
+    std::string_view normalizeQuery(std::string_view path) {
+        if (path.rfind("./", 0) == 0) path.remove_prefix(2);
+        while (!path.empty() && path.back() == '/') path.remove_suffix(1);
+        return path;
+    }
+
+    // Double hashing: probe i is h1 + i * h2 over the filter's bits
+    template <typename Visit>
+    void forEachProbe(std::string_view path, size_t bits, Visit visit) {
+        uint64_t h1 = Utils::fnv1a(path);
+        uint64_t h2 = Utils::mix(h1) | 1;
+        for (size_t i = 0; i < BLOOM_HASHES; ++i) {
+            visit(static_cast<size_t>((h1 + i * h2) % bits));
+        }
+    }
+
+    void buildBloom(CommitGraph::Entry& entry, const std::vector<std::string>& changed) {
+        // Every changed file also marks its parent directories, so that
+        // "log -- dir" can use the same filter
+        std::unordered_set<std::string_view> keys;
+        for (const auto& path : changed) {
+            std::string_view view(path);
+            keys.insert(view);
+            for (size_t slash = view.find('/'); slash != std::string_view::npos;
+                 slash = view.find('/', slash + 1)) {
+                keys.insert(view.substr(0, slash));
+            }
+        }
+
+        if (keys.size() > BLOOM_MAX_PATHS) {
+            entry.allChanged = true;
+            return;
+        }
+        if (keys.empty()) return;
+
+        size_t words = (keys.size() * BLOOM_BITS_PER_PATH + 63) / 64;
+        entry.bloom.assign(words, 0);
+        size_t bits = words * 64;
+        for (std::string_view key : keys) {
+            forEachProbe(key, bits, [&](size_t bit) {
+                entry.bloom[bit / 64] |= 1ULL << (bit % 64);
+            });
+        }
+    }
+
+    // Line format: <hash> <time> <generation> <parent,parent|-> <bloom hex|-|*>
+    std::string serialize(const std::string& hash, const CommitGraph::Entry& entry) {
+        std::ostringstream line;
+        line << hash << " " << entry.time << " " << entry.generation << " ";
+        if (entry.parents.empty()) {
+            line << "-";
+        }
+        for (size_t i = 0; i < entry.parents.size(); ++i) {
+            line << (i ? "," : "") << entry.parents[i];
+        }
+        line << " ";
+        if (entry.allChanged) {
+            line << "*";
+        } else if (entry.bloom.empty()) {
+            line << "-";
+        } else {
+            for (uint64_t word : entry.bloom) {
+                line << std::hex << std::setw(16) << std::setfill('0') << word;
+            }
+        }
+        return line.str();
+    }
+
+    bool parseLine(const std::string& line, std::string& hash, CommitGraph::Entry& entry) {
+        std::istringstream iss(line);
+        std::string parents, bloom;
+        long long time = 0;
+        if (!(iss >> hash >> time >> entry.generation >> parents >> bloom)) return false;
+
+        entry.time = static_cast<std::time_t>(time);
+        if (parents != "-") {
+            std::istringstream list(parents);
+            std::string parent;
+            while (std::getline(list, parent, ',')) entry.parents.push_back(parent);
+        }
+        if (bloom == "*") {
+            entry.allChanged = true;
+        } else if (bloom != "-") {
+            for (size_t i = 0; i + 16 <= bloom.size(); i += 16) {
+                entry.bloom.push_back(std::stoull(bloom.substr(i, 16), nullptr, 16));
+            }
+        }
+        return true;
+    }
+
+    GraphState& loadedGraph() {
+        GraphState& state = graphState();
+        if (!state.loaded) {
+            std::ifstream file(Constants::COMMIT_GRAPH_FILE);
+            std::string line;
+            while (std::getline(file, line)) {
+                std::string hash;
+                CommitGraph::Entry entry;
+                if (parseLine(line, hash, entry)) {
+                    state.entries[hash] = std::move(entry);
+                }
+            }
+            state.loaded = true;
+        }
+        return state;
+    }
+}
+
+// Paths whose blob differs between a commit and its first parent. Two
+// manifests are compared structurally, reading only the nodes they do not
+// share; commits from before manifests fall back to comparing full lists.
+std::vector<std::string> CommitGraph::changedPaths(const std::string& commitHash) {
+    CommitInfo commit;
+    std::vector<std::string> changed;
+    if (!Utils::readCommit(commitHash, commit)) return changed;
+
+    CommitInfo parent;
+    bool hasParent = !commit.parents.empty() && Utils::readCommit(commit.parents.front(), parent);
+    if (!commit.manifest.empty() && (!hasParent || !parent.manifest.empty())) {
+        Manifest::diff(hasParent ? parent.manifest : "", commit.manifest,
+                       [&](const std::string& path, const std::string&, const std::string&) {
+                           changed.push_back(path);
+                       });
+        std::sort(changed.begin(), changed.end());
+        return changed;
+    }
+
+    std::unordered_map<std::string, std::string> parentFiles;
+    if (!commit.parents.empty()) {
+        parentFiles = MergeManager::getCommitFiles(commit.parents.front());
+    }
+
+    for (const auto& [path, hash] : MergeManager::getCommitFiles(commitHash)) {
+        auto it = parentFiles.find(path);
+        if (it == parentFiles.end() || it->second != hash) {
+            changed.push_back(path);
+        }
+        if (it != parentFiles.end()) parentFiles.erase(it);
+    }
+    for (const auto& removed : parentFiles) {
+        changed.push_back(removed.first);
+    }
+
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    return changed;
+}
+
+// Graph entry for a commit, computing it (and any missing ancestors) on
+// first use. Returns nullptr if the commit object does not exist.
+const CommitGraph::Entry* CommitGraph::lookup(const std::string& commitHash) {
+    GraphState& state = loadedGraph();
+    auto found = state.entries.find(commitHash);
+    if (found != state.entries.end()) return &found->second;
+    if (commitHash.length() != 40 || !std::filesystem::exists(Utils::objectPath(commitHash))) {
+        return nullptr;
+    }
+
+    // Ancestors first (generation numbers depend on them); iterative so deep
+    // histories cannot overflow the stack
+    std::unordered_map<std::string, CommitInfo> parsed;
+    std::vector<std::string> work{commitHash};
+    while (!work.empty()) {
+        std::string current = work.back();
+        if (state.entries.count(current)) {
+            work.pop_back();
+            continue;
+        }
+
+        auto info = parsed.find(current);
+        if (info == parsed.end()) {
+            CommitInfo commit;
+            Utils::readCommit(current, commit);
+            info = parsed.emplace(current, std::move(commit)).first;
+        }
+
+        bool ready = true;
+        for (const auto& parent : info->second.parents) {
+            if (!state.entries.count(parent) && parent.length() == 40 &&
+                std::filesystem::exists(Utils::objectPath(parent))) {
+                work.push_back(parent);
+                ready = false;
+            }
+        }
+        if (!ready) continue;
+
+        Entry entry;
+        entry.parents = info->second.parents;
+        entry.time = info->second.time;
+        for (const auto& parent : entry.parents) {
+            auto parentEntry = state.entries.find(parent);
+            if (parentEntry != state.entries.end()) {
+                entry.generation = std::max(entry.generation, parentEntry->second.generation);
+            }
+        }
+        entry.generation += 1;
+        buildBloom(entry, changedPaths(current));
+
+        state.pendingLines.push_back(serialize(current, entry));
+        state.entries[current] = std::move(entry);
+        parsed.erase(current);
+        work.pop_back();
+    }
+    return &state.entries[commitHash];
+}
+
+// False means the commit definitely did not change path (file or directory)
+bool CommitGraph::mayChangePath(const Entry& entry, const std::string& path) {
+    if (entry.allChanged) return true;
+    if (entry.bloom.empty()) return false;
+
+    size_t bits = entry.bloom.size() * 64;
+    bool present = true;
+    forEachProbe(normalizeQuery(path), bits, [&](size_t bit) {
+        if (!(entry.bloom[bit / 64] & (1ULL << (bit % 64)))) present = false;
+    });
+    return present;
+}
+
+// Append entries computed in this process to the commit-graph file
+bool CommitGraph::save() {
+    GraphState& state = graphState();
+    if (state.pendingLines.empty()) return true;
+
+    std::ofstream file(Constants::COMMIT_GRAPH_FILE, std::ios::app);
+    if (!file) {
+        std::cerr << "Warning: Could not update " << Constants::COMMIT_GRAPH_FILE << "\n";
+        return false;
+    }
+    for (const auto& line : state.pendingLines) {
+        file << line << "\n";
+    }
+    state.pendingLines.clear();
+    return true;
+}
+
+} // namespace MiniGit
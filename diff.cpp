@@ -0,0 +1,57 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <sstream>
+
+namespace MiniGit {
+
+// Print one "<status>\t<path>" line per changed path, renames and copies as
+// "R<score>\t<old>\t<new>", ordered by (new) path
+bool Differ::showNameStatus(const std::string& from, const std::string& to, bool copies) {
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+
+    std::string fromCommit = RefStore::resolve(from);
+    std::string toCommit = RefStore::resolve(to);
+    if (fromCommit.empty() || toCommit.empty()) {
+        std::cerr << "Error: Unknown revision " << (fromCommit.empty() ? from : to) << "\n";
+        return false;
+    }
+
+    auto before = MergeManager::getCommitFiles(fromCommit);
+    auto after = MergeManager::getCommitFiles(toCommit);
+
+    std::vector<std::pair<std::string, std::string>> lines;  // sort key, line
+    std::unordered_set<std::string> paired;
+    for (const auto& rename : RenameDetector::detect(before, after, copies)) {
+        std::ostringstream line;
+        line << (rename.copy ? 'C' : 'R') << std::setw(3) << std::setfill('0') << rename.similarity
+             << "\t" << rename.from << "\t" << rename.to;
+        lines.emplace_back(rename.to, line.str());
+        paired.insert(rename.to);
+        if (!rename.copy) paired.insert(rename.from);
+    }
+
+    for (const auto& [path, hash] : before) {
+        auto it = after.find(path);
+        if (it == after.end()) {
+            if (!paired.count(path)) lines.emplace_back(path, "D\t" + path);
+        } else if (it->second != hash) {
+            lines.emplace_back(path, "M\t" + path);
+        }
+    }
+    for (const auto& [path, hash] : after) {
+        if (!before.count(path) && !paired.count(path)) lines.emplace_back(path, "A\t" + path);
+    }
+
+    std::sort(lines.begin(), lines.end());
+    std::string out;
+    for (const auto& line : lines) out += line.second + "\n";
+    std::cout << out;
+    return true;
+}
+
+} // namespace MiniGit
@@ -0,0 +1,408 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <map>
+#include <atomic>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+
+namespace MiniGit {
+
+namespace {
+    const size_t FLUSH_BYTES = 32 * 1024 * 1024;  // pending object bytes before a batch write
+
+    using FileList = std::map<std::string, std::string>;
+
+    bool isObjectId(const std::string& ref) {
+        return ref.size() == 40 && std::all_of(ref.begin(), ref.end(), [](unsigned char c) {
+            return std::isxdigit(c) != 0;
+        });
+    }
+
+    // Objects are collected in memory and written in parallel batches;
+    // hashes known to exist are remembered so nothing is checked twice
+    class ObjectBatch {
+    public:
+        void add(const std::string& hash, std::string content, bool blob) {
+            if (!known.insert(hash).second) return;
+            if (std::filesystem::exists(Utils::objectPath(hash))) return;
+            bytes += content.size();
+            pending.push_back({hash, std::move(content), blob});
+            if (bytes >= FLUSH_BYTES) flush();
+        }
+
+        bool flush() {
+            std::atomic<bool> ok{true};
+            Utils::parallelFor(pending.size(), [&](size_t i) {
+                const Pending& object = pending[i];
+                bool written = object.blob ? ChunkStore::writeBlob(object.hash, object.content)
+                                           : Utils::writeObject(object.hash, object.content);
+                if (!written) ok = false;
+            });
+            written += pending.size();
+            pending.clear();
+            bytes = 0;
+            if (!ok) failed = true;
+            return !failed;
+        }
+
+        // Queued or already stored by this import
+        bool contains(const std::string& hash) const { return known.count(hash) > 0; }
+
+        size_t objectsWritten() const { return written; }
+
+    private:
+        struct Pending {
+            std::string hash;
+            std::string content;
+            bool blob;
+        };
+        std::vector<Pending> pending;
+        std::unordered_set<std::string> known;
+        size_t bytes = 0;
+        size_t written = 0;
+        bool failed = false;
+    };
+
+    // Line-oriented reader over the import stream with one line of lookahead
+    class StreamReader {
+    public:
+        explicit StreamReader(std::istream& in) : in(in) {}
+
+        bool next(std::string& line) {
+            if (hasPeeked) {
+                line = std::move(peeked);
+                hasPeeked = false;
+                return true;
+            }
+            while (std::getline(in, line)) {
+                ++lineNumber;
+                if (!line.empty() && line[0] != '#') return true;
+            }
+            return false;
+        }
+
+        void pushBack(std::string line) {
+            peeked = std::move(line);
+            hasPeeked = true;
+        }
+
+        // "data <count>" followed by exactly count bytes, or "data <<DELIM"
+        // followed by lines up to DELIM. On failure, why() says what was wrong.
+        bool readData(const std::string& header, std::string& data) {
+            problem.clear();
+            if (header.rfind("data ", 0) != 0) return false;
+            std::string spec = header.substr(5);
+            if (spec.rfind("<<", 0) == 0) {
+                std::string delimiter = spec.substr(2), line;
+                data.clear();
+                while (std::getline(in, line)) {
+                    ++lineNumber;
+                    if (line == delimiter) return true;
+                    data += line + "\n";
+                }
+                return false;
+            }
+            char* end = nullptr;
+            errno = 0;
+            unsigned long long count = std::strtoull(spec.c_str(), &end, 10);
+            if (spec.empty() || !std::isdigit(static_cast<unsigned char>(spec[0])) || errno != 0 || *end != '\0') {
+                problem = "bad data length '" + spec + "'";
+                return false;
+            }
+            data.assign(count, '\0');
+            if (count && !in.read(&data[0], static_cast<std::streamsize>(count))) {
+                problem = "data ends before its length";
+                return false;
+            }
+            if (in.peek() == '\n') in.get();  // optional LF after the data
+            return true;
+        }
+
+        size_t line() const { return lineNumber; }
+
+        std::string why(const std::string& fallback) const { return problem.empty() ? fallback : problem; }
+
+    private:
+        std::istream& in;
+        std::string peeked;
+        bool hasPeeked = false;
+        size_t lineNumber = 0;
+        std::string problem;
+    };
+
+    // Paths may be C-style quoted
+    std::string parsePath(const std::string& text, size_t& pos) {
+        std::string path;
+        if (pos < text.size() && text[pos] == '"') {
+            for (++pos; pos < text.size() && text[pos] != '"'; ++pos) {
+                char ch = text[pos];
+                if (ch == '\\' && pos + 1 < text.size()) {
+                    ch = text[++pos];
+                    if (ch == 'n') ch = '\n';
+                    else if (ch == 't') ch = '\t';
+                }
+                path += ch;
+            }
+            ++pos;
+        } else {
+            size_t end = text.find(' ', pos);
+            path = text.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+            pos = end == std::string::npos ? text.size() : end;
+        }
+        if (pos < text.size() && text[pos] == ' ') ++pos;
+        return path;
+    }
+
+    std::string branchOf(const std::string& ref) {
+        const std::string prefix = "refs/heads/";
+        return ref.rfind(prefix, 0) == 0 ? ref.substr(prefix.size()) : ref;
+    }
+}
+
+// Import a fast-import stream (the blob/commit/reset/mark subset of git's
+// format). Marks and the latest file list of every ref stay in memory;
+// blobs and commits are written in parallel batches, each commit's manifest
+// is derived copy-on-write from its first parent's, and refs are only
+// updated once at the end.
+bool FastImporter::run(std::istream& in) {
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    StreamReader reader(in);
+    ObjectBatch batch;
+    std::unordered_map<std::string, std::string> marks;  // ":<n>" -> hash
+    std::map<std::string, std::string> tips;              // ref -> commit
+    std::unordered_map<std::string, FileList> manifests;  // recent commits' file lists
+    std::unordered_map<std::string, std::string> roots;   // and their manifest roots
+    size_t blobs = 0, commits = 0;
+
+    auto fail = [&](const std::string& message) {
+        std::cerr << "Error: fast-import line " << reader.line() << ": " << message << "\n";
+        return false;
+    };
+    auto resolve = [&](const std::string& ref) -> std::string {
+        if (ref.rfind(":", 0) == 0) {
+            auto it = marks.find(ref);
+            return it == marks.end() ? "" : it->second;
+        }
+        auto tip = tips.find(ref);
+        if (tip != tips.end()) return tip->second;
+        if (isObjectId(ref)) {
+            // A raw id must name an object this import wrote or the store has
+            if (batch.contains(ref) || std::filesystem::exists(Utils::objectPath(ref))) return ref;
+            return "";
+        }
+        return RefStore::resolve(ref);
+    };
+    // A ref's tip is usually the next commit's parent; its list is then
+    // handed over rather than copied
+    auto manifestOf = [&](const std::string& commitHash, bool take) -> FileList {
+        auto cached = manifests.find(commitHash);
+        if (cached != manifests.end()) {
+            if (!take) return cached->second;
+            FileList files = std::move(cached->second);
+            manifests.erase(cached);
+            return files;
+        }
+        batch.flush();  // the commit may still be pending
+        FileList files;
+        for (const auto& file : MergeManager::getCommitFiles(commitHash)) files.insert(file);
+        return files;
+    };
+    // Copy-on-write from a parent's manifest, known here for the commits of
+    // this import and read from the store otherwise
+    auto childRoot = [&](const std::string& parent, const std::unordered_map<std::string, std::string>& changes) {
+        auto cached = roots.find(parent);
+        if (cached != roots.end()) return Manifest::update(cached->second, changes);
+        batch.flush();
+        return Manifest::updateCommit(parent, changes);
+    };
+
+    std::string line;
+    while (reader.next(line)) {
+        if (line == "blob") {
+            std::string mark, data;
+            if (!reader.next(line)) return fail("unexpected end of stream");
+            if (line.rfind("mark ", 0) == 0) {
+                mark = line.substr(5);
+                if (!reader.next(line)) return fail("unexpected end of stream");
+            }
+            if (line.rfind("original-oid ", 0) == 0 && !reader.next(line)) return fail("unexpected end of stream");
+            if (!reader.readData(line, data)) return fail(reader.why("expected data"));
+
+            std::string hash = Utils::computeSHA1(data);
+            if (!mark.empty()) marks[mark] = hash;
+            batch.add(hash, std::move(data), true);
+            ++blobs;
+        } else if (line.rfind("commit ", 0) == 0) {
+            std::string ref = line.substr(7);
+            std::string mark, message;
+            std::time_t time = 0;
+            std::vector<std::string> parents;
+            bool hasFrom = false;
+
+            while (reader.next(line)) {
+                if (line.rfind("mark ", 0) == 0) {
+                    mark = line.substr(5);
+                } else if (line.rfind("author ", 0) == 0 || line.rfind("committer ", 0) == 0) {
+                    // "<name> <email> <seconds> <tz>": committer time wins
+                    size_t email = line.rfind('>');
+                    std::istringstream when(email == std::string::npos ? "" : line.substr(email + 1));
+                    long long seconds = 0;
+                    if (when >> seconds && (time == 0 || line[0] == 'c')) time = static_cast<std::time_t>(seconds);
+                } else if (line.rfind("data ", 0) == 0) {
+                    if (!reader.readData(line, message)) return fail(reader.why("expected commit message"));
+                } else if (line.rfind("from ", 0) == 0 || line.rfind("merge ", 0) == 0) {
+                    std::string parent = resolve(line.substr(line.find(' ') + 1));
+                    if (parent.empty()) return fail("unknown commit " + line.substr(line.find(' ') + 1));
+                    hasFrom = hasFrom || line[0] == 'f';
+                    parents.push_back(parent);
+                } else if (line.rfind("encoding ", 0) == 0 || line.rfind("original-oid ", 0) == 0) {
+                    continue;
+                } else {
+                    reader.pushBack(line);
+                    break;
+                }
+            }
+            if (!hasFrom) {
+                // A new commit on an existing ref continues from its tip
+                std::string tip = resolve(ref);
+                if (!tip.empty()) parents.insert(parents.begin(), tip);
+            }
+
+            auto tip = tips.find(ref);
+            bool fromTip = !parents.empty() && tip != tips.end() && tip->second == parents.front();
+            FileList files = parents.empty() ? FileList() : manifestOf(parents.front(), fromTip);
+            std::unordered_map<std::string, std::string> changes;  // "" removes the path
+            while (reader.next(line)) {
+                if (line.rfind("M ", 0) == 0) {
+                    // M <mode> <dataref> <path>
+                    std::istringstream fields(line.substr(2));
+                    std::string mode, dataref;
+                    fields >> mode >> dataref;
+                    size_t pos = 2 + mode.size() + 1 + dataref.size() + 1;
+                    std::string path = parsePath(line, pos);
+                    std::string hash;
+                    if (dataref == "inline") {
+                        std::string data;
+                        if (!reader.next(line) || !reader.readData(line, data)) return fail(reader.why("expected inline data"));
+                        hash = Utils::computeSHA1(data);
+                        batch.add(hash, std::move(data), true);
+                        ++blobs;
+                    } else {
+                        hash = resolve(dataref);
+                        if (hash.empty()) return fail("unknown blob " + dataref);
+                    }
+                    files[path] = hash;
+                    changes[path] = hash;
+                } else if (line.rfind("D ", 0) == 0) {
+                    size_t pos = 2;
+                    std::string path = parsePath(line, pos);
+                    if (files.erase(path)) changes[path] = "";
+                    std::string prefix = path + "/";
+                    for (auto it = files.lower_bound(prefix);
+                         it != files.end() && it->first.compare(0, prefix.size(), prefix) == 0;) {
+                        changes[it->first] = "";
+                        it = files.erase(it);
+                    }
+                } else if (line.rfind("C ", 0) == 0 || line.rfind("R ", 0) == 0) {
+                    size_t pos = 2;
+                    std::string source = parsePath(line, pos);
+                    std::string target = parsePath(line, pos);
+                    auto it = files.find(source);
+                    if (it == files.end()) return fail("no such path " + source);
+                    files[target] = it->second;
+                    changes[target] = it->second;
+                    if (line[0] == 'R') {
+                        files.erase(source);
+                        changes[source] = "";
+                    }
+                } else if (line == "deleteall") {
+                    for (const auto& file : files) changes[file.first] = "";
+                    files.clear();
+                } else {
+                    reader.pushBack(line);
+                    break;
+                }
+            }
+
+            std::string root = childRoot(parents.empty() ? "" : parents.front(), changes);
+            if (root.empty()) return fail("could not build manifest");
+
+            // Same object layout as Committer. A commit object holds a single
+            // "message" line, so only the first line of a multi-line message
+            // is imported; the body is dropped.
+            std::string summary = message.substr(0, message.find('\n'));
+            std::ostringstream content;
+            content << "message " << summary << "\n"
+                    << "time " << (time ? time : std::time(nullptr)) << "\n";
+            if (parents.empty()) content << "parent \n";
+            for (const auto& parent : parents) content << "parent " << parent << "\n";
+            content << "branch " << branchOf(ref) << "\n"
+                    << "manifest " << root << "\n";
+
+            std::string commitText = content.str();
+            std::string commitHash = Utils::computeSHA1(commitText);
+            batch.add(commitHash, std::move(commitText), false);
+            if (!mark.empty()) marks[mark] = commitHash;
+
+            // Only each ref's latest manifest is worth keeping around
+            auto previous = tips.find(ref);
+            if (previous != tips.end()) {
+                manifests.erase(previous->second);
+                roots.erase(previous->second);
+            }
+            tips[ref] = commitHash;
+            manifests[commitHash] = std::move(files);
+            roots[commitHash] = root;
+            ++commits;
+        } else if (line.rfind("reset ", 0) == 0) {
+            std::string ref = line.substr(6);
+            if (reader.next(line)) {
+                if (line.rfind("from ", 0) == 0) {
+                    std::string target = resolve(line.substr(5));
+                    if (target.empty()) return fail("unknown commit " + line.substr(5));
+                    tips[ref] = target;
+                    continue;
+                }
+                reader.pushBack(line);
+            }
+            tips[ref] = "";  // the next commit on ref starts a new root
+        } else if (line.rfind("progress ", 0) == 0) {
+            std::cout << line << "\n";
+        } else if (line == "done") {
+            break;
+        } else if (line.rfind("feature ", 0) == 0 || line.rfind("option ", 0) == 0 || line == "checkpoint") {
+            continue;
+        } else {
+            return fail("unsupported command '" + line + "'");
+        }
+    }
+
+    // Objects first, so no ref ever points at a missing commit
+    if (!batch.flush()) {
+        std::cerr << "Error: Failed to write imported objects\n";
+        return false;
+    }
+    for (const auto& [ref, hash] : tips) {
+        if (hash.empty()) continue;
+        if (!RefStore::writeRef(ref, hash)) {
+            std::cerr << "Error: Failed to update " << ref << "\n";
+            return false;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "Imported " << blobs << " blob(s), " << commits << " commit(s) and " << tips.size()
+              << " ref(s); " << batch.objectsWritten() << " new object(s) in " << seconds << " s\n";
+    return true;
+}
+
+} // namespace MiniGit
@@ -0,0 +1,224 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+
+namespace MiniGit {
+
+namespace {
+    // Root commits made by init/branch used a random id rather than a
+    // content hash; they cannot be verified but are not corrupt. Only the
+    // exact content they write ("message Initial commit", then one "time"
+    // line) qualifies; anything else with a wrong hash is damage.
+    bool isPlaceholderCommit(std::string_view content) {
+        const std::string_view prefix = "message Initial commit\ntime ";
+        if (content.size() <= prefix.size() + 1 || content.substr(0, prefix.size()) != prefix ||
+            content.back() != '\n') {
+            return false;
+        }
+        std::string_view time = content.substr(prefix.size(), content.size() - prefix.size() - 1);
+        return std::all_of(time.begin(), time.end(),
+                           [](unsigned char c) { return std::isdigit(c) != 0; });
+    }
+
+    std::string objectHash(std::string_view content) {
+        if (ChunkStore::isChunkList(content)) return ChunkStore::contentHash(content);
+        return Utils::computeSHA1(content);
+    }
+
+    struct Report {
+        std::mutex mutex;
+        std::vector<std::string> errors;
+
+        void add(const std::string& message) {
+            std::lock_guard<std::mutex> lock(mutex);
+            errors.push_back(message);
+        }
+    };
+}
+
+// Re-hash every object on all cores, then validate the commit DAG reachable
+// from refs, HEAD and staging: parents, manifest nodes and file blobs must
+// exist.
+bool IntegrityChecker::fsck() {
+    namespace fs = std::filesystem;
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+
+    std::vector<std::string> objects;
+    std::error_code ec;
+    for (fs::directory_iterator dir(Constants::OBJECTS_DIR, ec), end; !ec && dir != end; dir.increment(ec)) {
+        std::string prefix = dir->path().filename().string();
+        if (!dir->is_directory() || prefix.size() != 2) continue;
+        std::error_code fileError;
+        for (fs::directory_iterator it(dir->path(), fileError); !fileError && it != end; it.increment(fileError)) {
+            objects.push_back(prefix + it->path().filename().string());
+        }
+    }
+    std::unordered_set<std::string> present(objects.begin(), objects.end());
+
+    // Pass 1: content must hash to the object's name
+    Report report;
+    std::atomic<size_t> bytes{0}, placeholders{0};
+    std::mutex chunkMutex;
+    std::unordered_map<std::string, std::vector<std::string>> chunkLists;
+    Utils::parallelFor(objects.size(), [&](size_t i) {
+        ObjectView object = Utils::readObject(objects[i]);
+        if (!object.valid()) {
+            report.add("error: cannot read object " + objects[i]);
+            return;
+        }
+        bytes += object.size();
+        if (ChunkStore::isChunkList(object.view())) {
+            // Named by the whole file's hash, so verify the reassembled bytes
+            std::lock_guard<std::mutex> lock(chunkMutex);
+            for (const auto& chunk : ChunkStore::chunksOf(object.view())) {
+                chunkLists[objects[i]].push_back(chunk.hash);
+            }
+        }
+        std::string actual = objectHash(object.view());
+        if (actual == objects[i]) return;
+
+        if (actual.empty()) {
+            report.add("error: chunked blob " + objects[i] + " has a missing or damaged chunk");
+        } else if (isPlaceholderCommit(object.view())) {
+            ++placeholders;
+        } else {
+            report.add("error: hash mismatch in object " + objects[i]);
+        }
+    });
+
+    // Pass 2: walk the DAG a generation of commits at a time, validating
+    // each frontier in parallel
+    std::vector<std::pair<std::string, std::string>> roots;
+    for (const auto& ref : RefStore::listRefs("")) roots.emplace_back(ref.first, ref.second);
+    roots.emplace_back("HEAD", RefStore::resolveHead());
+
+    std::unordered_set<std::string> reachable;
+    std::vector<std::string> frontier;
+    for (const auto& [name, hash] : roots) {
+        if (hash.empty()) continue;
+        if (!present.count(hash)) {
+            report.add("error: " + name + " points to missing commit " + hash);
+        } else if (reachable.insert(hash).second) {
+            frontier.push_back(hash);
+        }
+    }
+    for (const auto& [path, hash] : FileAdder::getStagedEntries()) {
+        if (hash.empty()) continue;  // a staged removal
+        if (!present.count(hash)) {
+            report.add("error: staged file " + path + " has missing blob " + hash);
+        }
+        reachable.insert(hash);
+    }
+
+    size_t commits = 0;
+    std::vector<std::string> manifestNodes;
+    while (!frontier.empty()) {
+        commits += frontier.size();
+        std::vector<CommitInfo> parsed(frontier.size());
+        Utils::parallelFor(frontier.size(), [&](size_t i) {
+            CommitInfo& commit = parsed[i];
+            if (!Utils::readCommit(frontier[i], commit) || commit.time == 0) {
+                report.add("error: " + frontier[i] + " is not a valid commit");
+                return;
+            }
+            for (const auto& parent : commit.parents) {
+                if (!present.count(parent)) {
+                    report.add("error: commit " + frontier[i] + " has missing parent " + parent);
+                }
+            }
+            for (const auto& [path, blob] : commit.files) {
+                if (!present.count(blob)) {
+                    report.add("error: commit " + frontier[i] + " has missing blob " + blob + " for " + path);
+                }
+            }
+            if (!commit.manifest.empty() && !present.count(commit.manifest)) {
+                report.add("error: commit " + frontier[i] + " has missing manifest " + commit.manifest);
+            }
+        });
+
+        std::vector<std::string> next;
+        for (const auto& commit : parsed) {
+            for (const auto& file : commit.files) reachable.insert(file.second);
+            if (!commit.manifest.empty() && present.count(commit.manifest) &&
+                reachable.insert(commit.manifest).second) {
+                manifestNodes.push_back(commit.manifest);
+            }
+            for (const auto& parent : commit.parents) {
+                if (present.count(parent) && reachable.insert(parent).second) next.push_back(parent);
+            }
+        }
+        frontier.swap(next);
+    }
+
+    // Manifest nodes a level at a time; nodes shared between commits are
+    // checked once
+    while (!manifestNodes.empty()) {
+        std::vector<std::vector<std::string>> children(manifestNodes.size());
+        std::vector<std::vector<std::pair<std::string, std::string>>> files(manifestNodes.size());
+        Utils::parallelFor(manifestNodes.size(), [&](size_t i) {
+            const std::string& node = manifestNodes[i];
+            if (!Manifest::readNode(node, children[i], files[i])) {
+                report.add("error: manifest node " + node + " is damaged");
+                return;
+            }
+            for (const auto& child : children[i]) {
+                if (!present.count(child)) report.add("error: manifest node " + node + " has missing child " + child);
+            }
+            for (const auto& [path, blob] : files[i]) {
+                if (!present.count(blob)) {
+                    report.add("error: manifest node " + node + " has missing blob " + blob + " for " + path);
+                }
+            }
+        });
+
+        std::vector<std::string> next;
+        for (size_t i = 0; i < manifestNodes.size(); ++i) {
+            for (const auto& file : files[i]) reachable.insert(file.second);
+            for (const auto& child : children[i]) {
+                if (present.count(child) && reachable.insert(child).second) next.push_back(child);
+            }
+        }
+        manifestNodes.swap(next);
+    }
+
+    for (const auto& [list, chunks] : chunkLists) {
+        if (!reachable.count(list)) continue;
+        reachable.insert(chunks.begin(), chunks.end());
+    }
+
+    size_t dangling = std::count_if(objects.begin(), objects.end(),
+        [&](const std::string& hash) { return !reachable.count(hash); });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    double mib = bytes / (1024.0 * 1024.0);
+
+    std::sort(report.errors.begin(), report.errors.end());
+    for (const auto& error : report.errors) {
+        std::cerr << error << "\n";
+    }
+    std::cout << "Checked " << objects.size() << " object(s), " << commits << " reachable commit(s), "
+              << std::fixed << std::setprecision(1) << mib << " MiB in " << std::setprecision(2) << seconds
+              << " s (" << std::setprecision(1) << (seconds > 0 ? mib / seconds : 0.0) << " MiB/s, "
+              << Utils::workerCount() << " threads)\n";
+    if (placeholders) {
+        std::cout << placeholders << " placeholder root commit(s) with non-content ids\n";
+    }
+    if (dangling) {
+        std::cout << dangling << " dangling object(s) (remove with 'minigit prune')\n";
+    }
+    if (report.errors.empty()) {
+        std::cout << "No problems found\n";
+    }
+    return report.errors.empty();
+}
+
+} // namespace MiniGit
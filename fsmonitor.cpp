@@ -0,0 +1,334 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <csignal>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MiniGit {
+
+namespace {
+    const std::string JOURNAL_FILE = Constants::FSMONITOR_DIR + "/journal";
+    const std::string PID_FILE = Constants::FSMONITOR_DIR + "/pid";
+    const std::string COOKIE_PREFIX = "cookie-";
+    const size_t JOURNAL_LIMIT = 16 * 1024 * 1024;  // start a new instance beyond this
+    const auto SYNC_TIMEOUT = std::chrono::seconds(1);
+
+    // Journal layout: "instance <id>\n", then one line per event: a changed
+    // path, "!<cookie>" when a sync cookie appeared, or "*" after the kernel
+    // dropped events. Tokens are "<id>:<byte offset>".
+    bool parseToken(const std::string& token, std::string& id, size_t& offset) {
+        size_t colon = token.find(':');
+        if (colon == std::string::npos) return false;
+        id = token.substr(0, colon);
+        offset = std::strtoull(token.c_str() + colon + 1, nullptr, 10);
+        return !id.empty();
+    }
+
+    std::string journalInstance(std::string_view journal) {
+        const std::string prefix = "instance ";
+        size_t eol = journal.find('\n');
+        if (journal.rfind(prefix, 0) != 0 || eol == std::string_view::npos) return "";
+        return std::string(journal.substr(prefix.size(), eol - prefix.size()));
+    }
+
+    // Bytes of the journal up to its last complete line
+    size_t completeLength(std::string_view journal) {
+        size_t eol = journal.rfind('\n');
+        return eol == std::string_view::npos ? 0 : eol + 1;
+    }
+
+#ifdef __linux__
+    const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB |
+                                IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void onTerminate(int) {
+        stopRequested = 1;
+    }
+
+    pid_t runningPid() {
+        std::string text = Utils::readFile(PID_FILE);
+        pid_t pid = static_cast<pid_t>(std::strtol(text.c_str(), nullptr, 10));
+        return pid > 0 && ::kill(pid, 0) == 0 ? pid : 0;
+    }
+
+    class Watcher {
+    public:
+        bool run() {
+            inotifyFd = inotify_init1(IN_CLOEXEC);
+            if (inotifyFd < 0) return false;
+            if (!openJournal()) return false;
+
+            Utils::writeFile(PID_FILE, std::to_string(::getpid()));
+            watchTree("");
+            cookieWatch = inotify_add_watch(inotifyFd, Constants::FSMONITOR_DIR.c_str(), IN_CREATE);
+
+            alignas(inotify_event) char buffer[64 * 1024];
+            while (!stopRequested) {
+                ssize_t length = ::read(inotifyFd, buffer, sizeof(buffer));
+                if (length <= 0) break;  // EINTR on SIGTERM
+
+                std::string batch;
+                for (char* p = buffer; p < buffer + length;) {
+                    auto* event = reinterpret_cast<inotify_event*>(p);
+                    p += sizeof(inotify_event) + event->len;
+                    if (!handle(*event, batch)) stopRequested = 1;
+                }
+                append(batch);
+            }
+
+            std::error_code ec;
+            if (runningPid() == ::getpid()) std::filesystem::remove(PID_FILE, ec);
+            ::close(journalFd);
+            ::close(inotifyFd);
+            return true;
+        }
+
+    private:
+        // A new instance is written to a side file and renamed into place:
+        // clients may still have the old journal mapped, and truncating it
+        // under them would fault their reads
+        bool openJournal() {
+            std::string temp = JOURNAL_FILE + ".new";
+            int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+            if (fd < 0) return false;
+            std::string header = "instance " + Utils::generateHash().substr(0, 16) + "\n";
+            if (::write(fd, header.data(), header.size()) != static_cast<ssize_t>(header.size()) ||
+                ::rename(temp.c_str(), JOURNAL_FILE.c_str()) != 0) {
+                ::close(fd);
+                ::unlink(temp.c_str());
+                return false;
+            }
+            if (journalFd >= 0) ::close(journalFd);
+            journalFd = fd;
+            journalSize = header.size();
+            return true;
+        }
+
+        void append(const std::string& text) {
+            if (text.empty()) return;
+            if (journalSize + text.size() > JOURNAL_LIMIT) {
+                openJournal();  // outstanding tokens become invalid; clients rescan once
+            }
+            if (::write(journalFd, text.data(), text.size()) > 0) journalSize += text.size();
+        }
+
+        // Watch a directory and everything below it that is not ignored
+        void watchTree(const std::string& relative) {
+            std::string dir = relative.empty() ? "." : relative;
+            int wd = inotify_add_watch(inotifyFd, dir.c_str(), WATCH_MASK | IN_ONLYDIR);
+            if (wd < 0) return;
+            directories[wd] = relative;
+
+            std::error_code ec;
+            for (std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+                std::error_code typeError;
+                if (!it->is_directory(typeError) || it->is_symlink(typeError)) continue;
+                std::string name = it->path().filename().generic_string();
+                std::string path = relative.empty() ? name : relative + "/" + name;
+                if (!IgnoreRules::isIgnored(path, true)) watchTree(path);
+            }
+        }
+
+        // Journal one event; false once the repository itself is gone
+        bool handle(const inotify_event& event, std::string& batch) {
+            if (event.mask & IN_Q_OVERFLOW) {
+                batch += "*\n";
+                return true;
+            }
+            if (event.wd == cookieWatch) {
+                std::string name = event.len ? event.name : "";
+                if (name.rfind(COOKIE_PREFIX, 0) == 0) batch += "!" + name + "\n";
+                return true;
+            }
+
+            auto dir = directories.find(event.wd);
+            if (dir == directories.end()) return true;
+            if (event.mask & IN_IGNORED) {
+                directories.erase(dir);
+                return true;
+            }
+            if ((event.mask & (IN_DELETE_SELF | IN_MOVE_SELF)) && dir->second.empty()) {
+                return false;  // the working tree root went away
+            }
+
+            std::string name = event.len ? event.name : "";
+            std::string path = dir->second.empty() ? name : (name.empty() ? dir->second : dir->second + "/" + name);
+            if (path.empty() || path == Constants::GIT_DIR) return true;
+            if (event.mask & IN_ISDIR) {
+                if (IgnoreRules::isIgnored(path, true)) return true;
+                if (event.mask & (IN_CREATE | IN_MOVED_TO)) watchTree(path);
+            }
+            batch += path + "\n";
+            return true;
+        }
+
+        int inotifyFd = -1;
+        int journalFd = -1;
+        int cookieWatch = -1;
+        size_t journalSize = 0;
+        std::unordered_map<int, std::string> directories;  // watch -> relative path
+    };
+
+    // Wait until the watcher has journaled every event that happened before
+    // this call, by creating a cookie file and waiting for its echo. Only
+    // the journal of instance id past offset (the caller's token) can hold
+    // it, and each poll resumes where the previous one stopped.
+    bool synchronize(const std::string& id, size_t offset) {
+        std::string cookie = COOKIE_PREFIX + Utils::generateHash().substr(0, 12);
+        std::string cookiePath = Constants::FSMONITOR_DIR + "/" + cookie;
+        if (!Utils::writeFile(cookiePath, "")) return false;
+
+        std::string marker = "\n!" + cookie + "\n";
+        size_t from = offset > 0 ? offset - 1 : 0;  // the marker starts with the previous newline
+        auto deadline = std::chrono::steady_clock::now() + SYNC_TIMEOUT;
+        bool seen = false;
+        while (!seen && std::chrono::steady_clock::now() < deadline) {
+            ObjectView journal = ObjectView::open(JOURNAL_FILE);
+            std::string_view data = journal.view();
+            if (journalInstance(data) != id) break;  // restarted or rotated: the token is stale
+            if (from < data.size()) {
+                seen = data.find(marker, from) != std::string_view::npos;
+                size_t scanned = completeLength(data);
+                if (scanned > from + marker.size()) from = scanned - marker.size();
+            }
+            if (!seen) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::error_code ec;
+        std::filesystem::remove(cookiePath, ec);
+        return seen;
+    }
+#endif
+}
+
+bool FsMonitor::start() {
+#ifdef __linux__
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+    if (pid_t pid = runningPid()) {
+        std::cout << "fsmonitor already running (pid " << pid << ")\n";
+        return true;
+    }
+    Utils::makeDirectory(Constants::FSMONITOR_DIR);
+
+    pid_t pid = ::fork();
+    if (pid < 0) {
+        std::cerr << "Error: Could not start fsmonitor\n";
+        return false;
+    }
+    if (pid == 0) {
+        // Detach from the terminal and run until stopped
+        ::setsid();
+        int devNull = ::open("/dev/null", O_RDWR);
+        if (devNull >= 0) {
+            ::dup2(devNull, 0);
+            ::dup2(devNull, 1);
+            ::dup2(devNull, 2);
+        }
+        struct sigaction action {};
+        action.sa_handler = onTerminate;
+        ::sigaction(SIGTERM, &action, nullptr);
+        ::sigaction(SIGINT, &action, nullptr);
+        Watcher watcher;
+        ::_exit(watcher.run() ? 0 : 1);
+    }
+
+    // Ready once the watcher has written its pid (after the initial watches)
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (runningPid() != pid && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::cout << "fsmonitor started (pid " << pid << ")\n";
+    return true;
+#else
+    std::cerr << "Error: fsmonitor is only supported on Linux\n";
+    return false;
+#endif
+}
+
+bool FsMonitor::stop() {
+#ifdef __linux__
+    pid_t pid = runningPid();
+    if (!pid) {
+        std::cout << "fsmonitor is not running\n";
+        return true;
+    }
+    ::kill(pid, SIGTERM);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (runningPid() == pid && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::error_code ec;
+    std::filesystem::remove(PID_FILE, ec);
+    std::cout << "fsmonitor stopped\n";
+    return true;
+#else
+    return true;
+#endif
+}
+
+bool FsMonitor::isRunning() {
+#ifdef __linux__
+    return runningPid() != 0;
+#else
+    return false;
+#endif
+}
+
+// Token for "now", or "" if no watcher is running. Events still in flight
+// when it is taken are journaled after it, so they are never missed.
+std::string FsMonitor::currentToken() {
+    if (!isRunning()) return "";
+    ObjectView journal = ObjectView::open(JOURNAL_FILE);
+    std::string id = journalInstance(journal.view());
+    if (id.empty()) return "";
+    return id + ":" + std::to_string(completeLength(journal.view()));
+}
+
+// Paths reported as changed since token. False when the watcher cannot
+// vouch for the whole interval (not running, restarted, or overflowed);
+// callers must then scan the tree themselves.
+bool FsMonitor::changedSince(const std::string& token, std::unordered_set<std::string>& paths,
+                             std::string& newToken) {
+#ifdef __linux__
+    std::string id;
+    size_t offset = 0;
+    if (!parseToken(token, id, offset) || !isRunning() || !synchronize(id, offset)) return false;
+
+    ObjectView journal = ObjectView::open(JOURNAL_FILE);
+    std::string_view data = journal.view();
+    if (journalInstance(data) != id) return false;
+    size_t end = completeLength(data);
+    if (offset > end) return false;
+
+    std::string_view events = data.substr(offset, end - offset);
+    while (!events.empty()) {
+        size_t eol = events.find('\n');
+        std::string_view line = events.substr(0, eol);
+        events.remove_prefix(eol + 1);
+        if (line == "*") return false;
+        if (line.empty() || line[0] == '!') continue;
+        paths.emplace(line);
+    }
+    newToken = id + ":" + std::to_string(end);
+    return true;
+#else
+    (void)token;
+    (void)paths;
+    (void)newToken;
+    return false;
+#endif
+}
+
+} // namespace MiniGit
@@ -0,0 +1,240 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <regex>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <map>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace MiniGit {
+
+namespace {
+    const size_t BINARY_PROBE = 8000;  // a NUL in this prefix means binary
+
+    // Longest run of characters every match must contain, or "" if the
+    // pattern has none that can be proven (alternation, classes only, ...)
+    std::string requiredLiteral(const std::string& pattern) {
+        std::string best, run;
+        int depth = 0;
+        bool inClass = false;
+        auto endRun = [&] {
+            if (run.size() > best.size()) best = run;
+            run.clear();
+        };
+
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            char ch = pattern[i];
+            if (inClass) {
+                if (ch == '\\') ++i;
+                else if (ch == ']') inClass = false;
+                continue;
+            }
+            switch (ch) {
+                case '|':
+                    if (depth == 0) return "";
+                    break;
+                case '\\':
+                    if (i + 1 < pattern.size() && std::ispunct(static_cast<unsigned char>(pattern[i + 1]))) {
+                        if (depth == 0) run += pattern[++i];
+                        else ++i;
+                        continue;
+                    }
+                    // Any other escape (\d, \n, \x41, \u0041, \cJ, \1) stands for
+                    // something other than its own characters: end the run
+                    // and skip its operand too, or "\x41BC" would require
+                    // "41BC" and reject lines matching "ABC"
+                    endRun();
+                    if (++i < pattern.size()) {
+                        char escape = pattern[i];
+                        if (escape == 'x') i = std::min(i + 2, pattern.size() - 1);
+                        else if (escape == 'u') i = std::min(i + 4, pattern.size() - 1);
+                        else if (escape == 'c') i = std::min(i + 1, pattern.size() - 1);
+                        else if (std::isdigit(static_cast<unsigned char>(escape))) {
+                            while (i + 1 < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[i + 1]))) ++i;
+                        }
+                    }
+                    continue;
+                case '[':
+                    inClass = true;
+                    endRun();
+                    continue;
+                case '(':
+                    ++depth;
+                    endRun();
+                    continue;
+                case ')':
+                    --depth;
+                    endRun();
+                    continue;
+                case '*':
+                case '?':
+                case '{':
+                    // The previous character was optional after all
+                    if (!run.empty()) run.pop_back();
+                    endRun();
+                    if (ch == '{') i = std::min(pattern.find('}', i), pattern.size());
+                    continue;
+                case '+':
+                    endRun();
+                    continue;
+                case '.':
+                case '^':
+                case '$':
+                    endRun();
+                    continue;
+                default:
+                    if (depth == 0) run += ch;
+                    else endRun();
+                    continue;
+            }
+        }
+        endRun();
+        return best;
+    }
+
+    // Position of needle in haystack (npos if absent). With SSE2, sixteen
+    // candidate positions are tested at once by comparing the needle's first
+    // and last bytes; only positions where both agree are verified.
+    size_t findLiteral(std::string_view haystack, std::string_view needle, size_t from) {
+        if (needle.empty()) return from;
+        if (needle.size() > haystack.size()) return std::string_view::npos;
+        size_t last = needle.size() - 1;
+        size_t end = haystack.size() - last;  // candidate starts are < end
+        size_t i = from;
+
+#if defined(__SSE2__)
+        const __m128i first = _mm_set1_epi8(needle[0]);
+        const __m128i final = _mm_set1_epi8(needle[last]);
+        for (; i + 16 <= end; i += 16) {
+            __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack.data() + i));
+            __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack.data() + i + last));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, final))));
+            while (mask) {
+                unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+                if (std::memcmp(haystack.data() + i + bit + 1, needle.data() + 1, last) == 0) {
+                    return i + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+#endif
+        return i < end ? haystack.find(needle, i) : std::string_view::npos;
+    }
+
+    struct BlobMatches {
+        std::vector<std::pair<size_t, std::string>> lines;  // line number, text
+        bool binaryMatch = false;
+    };
+
+    // Regex-match only the lines that contain the required literal
+    void searchBlob(std::string_view content, const std::string& literal, const std::regex& regex,
+                    BlobMatches& result) {
+        bool binary = std::memchr(content.data(), '\0', std::min(content.size(), BINARY_PROBE)) != nullptr;
+
+        size_t lineNumber = 1;
+        size_t counted = 0;  // content offset that lineNumber refers to
+        size_t pos = 0;
+        while (pos < content.size()) {
+            size_t hit = findLiteral(content, literal, pos);
+            if (hit == std::string_view::npos) break;
+
+            size_t lineStart = hit == 0 ? std::string_view::npos : content.rfind('\n', hit - 1);
+            lineStart = lineStart == std::string_view::npos ? 0 : lineStart + 1;
+            size_t lineEnd = content.find('\n', hit);
+            if (lineEnd == std::string_view::npos) lineEnd = content.size();
+
+            lineNumber += std::count(content.begin() + counted, content.begin() + lineStart, '\n');
+            counted = lineStart;
+
+            std::string_view line = content.substr(lineStart, lineEnd - lineStart);
+            if (std::regex_search(line.begin(), line.end(), regex)) {
+                if (binary) {
+                    result.binaryMatch = true;  // no point listing lines
+                    return;
+                }
+                result.lines.emplace_back(lineNumber, std::string(line));
+            }
+            pos = lineEnd + 1;
+        }
+    }
+}
+
+// Search every file of a commit straight from the object store. Each
+// distinct blob is read and searched once on the worker pool, no matter how
+// many paths share it; lines are only handed to the regex engine when they
+// contain the pattern's required literal.
+bool Grepper::grep(const std::string& pattern, const std::string& revision, bool ignoreCase) {
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+
+    std::string commitHash = RefStore::resolve(revision);
+    if (commitHash.empty()) {
+        std::cerr << "Error: Unknown revision " << (revision.empty() ? "HEAD" : revision) << "\n";
+        return false;
+    }
+
+    std::regex regex;
+    try {
+        auto flags = std::regex::ECMAScript | std::regex::optimize;
+        regex = std::regex(pattern, ignoreCase ? flags | std::regex::icase : flags);
+    } catch (const std::regex_error& e) {
+        std::cerr << "Error: Invalid pattern '" << pattern << "': " << e.what() << "\n";
+        return false;
+    }
+    std::string literal = ignoreCase ? "" : requiredLiteral(pattern);
+
+    std::map<std::string, std::string> files;  // sorted by path for output
+    std::unordered_map<std::string, size_t> blobIndex;
+    std::vector<std::string> blobs;
+    for (const auto& [path, hash] : MergeManager::getCommitFiles(commitHash)) {
+        files.emplace(path, hash);
+        if (blobIndex.emplace(hash, blobs.size()).second) blobs.push_back(hash);
+    }
+
+    std::vector<BlobMatches> results(blobs.size());
+    std::vector<char> damaged(blobs.size(), 0);
+    Utils::parallelFor(blobs.size(), [&](size_t i) {
+        ObjectView object = Utils::readObject(blobs[i]);
+        if (ChunkStore::isChunkList(object.view())) {
+            std::string content;
+            if (!ChunkStore::readContent(object.view(), content)) {
+                damaged[i] = 1;
+                return;
+            }
+            searchBlob(content, literal, regex, results[i]);
+        } else {
+            searchBlob(object.view(), literal, regex, results[i]);
+        }
+    });
+    for (size_t i = 0; i < blobs.size(); ++i) {
+        if (!damaged[i]) continue;
+        std::cerr << "Error: Missing or damaged chunk in blob " << blobs[i] << "\n";
+        return false;
+    }
+
+    std::string out;
+    bool found = false;
+    for (const auto& [path, hash] : files) {
+        const BlobMatches& matches = results[blobIndex[hash]];
+        if (matches.binaryMatch) {
+            out += "Binary file " + path + " matches\n";
+            found = true;
+            continue;
+        }
+        for (const auto& [number, text] : matches.lines) {
+            out += path + ":" + std::to_string(number) + ":" + text + "\n";
+            found = true;
+        }
+    }
+    std::cout << out;
+    return found;
+}
+
+} // namespace MiniGit
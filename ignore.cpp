@@ -0,0 +1,268 @@
+#include "minigit.hpp"
+#include <fstream>
+#include <bitset>
+#include <memory>
+#include <unordered_set>
+
+namespace MiniGit {
+
+namespace {
+    // One state of a compiled glob automaton. Consuming states advance to the
+    // next state; stars also loop on themselves, and "**/" may skip its slash.
+    struct GlobState {
+        enum Kind { Char, Any, Class, Star, DoubleStar, Accept } kind = Char;
+        char c = 0;
+        std::bitset<256> set;
+        int skipTo = -1;
+    };
+
+    struct Glob {
+        std::vector<GlobState> states;
+        bool anchored = false;
+        bool dirOnly = false;
+
+        // Simulate the NFA over the text; states only have forward epsilons,
+        // so one left-to-right pass computes each closure
+        bool matches(std::string_view text) const {
+            std::vector<char> current(states.size(), 0), next(states.size(), 0);
+            current[0] = 1;
+            closure(current);
+
+            for (char ch : text) {
+                std::fill(next.begin(), next.end(), 0);
+                bool any = false;
+                unsigned char uc = static_cast<unsigned char>(ch);
+                for (size_t i = 0; i < states.size(); ++i) {
+                    if (!current[i]) continue;
+                    const GlobState& state = states[i];
+                    switch (state.kind) {
+                        case GlobState::Char:
+                            if (state.c == ch) next[i + 1] = any = 1;
+                            break;
+                        case GlobState::Any:
+                            if (ch != '/') next[i + 1] = any = 1;
+                            break;
+                        case GlobState::Class:
+                            if (ch != '/' && state.set.test(uc)) next[i + 1] = any = 1;
+                            break;
+                        case GlobState::Star:
+                            if (ch != '/') next[i] = any = 1;
+                            break;
+                        case GlobState::DoubleStar:
+                            next[i] = any = 1;
+                            break;
+                        case GlobState::Accept:
+                            break;
+                    }
+                }
+                if (!any) return false;
+                closure(next);
+                current.swap(next);
+            }
+            return current.back() != 0;
+        }
+
+        void closure(std::vector<char>& active) const {
+            for (size_t i = 0; i < states.size(); ++i) {
+                if (!active[i]) continue;
+                const GlobState& state = states[i];
+                if (state.kind == GlobState::Star || state.kind == GlobState::DoubleStar) {
+                    active[i + 1] = 1;
+                }
+                if (state.skipTo >= 0) active[state.skipTo] = 1;
+            }
+        }
+    };
+
+    Glob compileGlob(const std::string& pattern) {
+        Glob glob;
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            char ch = pattern[i];
+            GlobState state;
+
+            if (ch == '*') {
+                if (i + 1 < pattern.size() && pattern[i + 1] == '*') {
+                    state.kind = GlobState::DoubleStar;
+                    ++i;
+                    if (i + 1 < pattern.size() && pattern[i + 1] == '/') {
+                        // "**/" also matches zero directories
+                        state.skipTo = static_cast<int>(glob.states.size()) + 2;
+                    }
+                } else {
+                    state.kind = GlobState::Star;
+                }
+            } else if (ch == '?') {
+                state.kind = GlobState::Any;
+            } else if (ch == '[' && pattern.find(']', i + 2) != std::string::npos) {
+                state.kind = GlobState::Class;
+                size_t j = i + 1;
+                bool negate = j < pattern.size() && (pattern[j] == '!' || pattern[j] == '^');
+                if (negate) ++j;
+                size_t first = j;
+                for (; j < pattern.size() && (pattern[j] != ']' || j == first); ++j) {
+                    unsigned char lo = static_cast<unsigned char>(pattern[j]);
+                    unsigned char hi = lo;
+                    if (j + 2 < pattern.size() && pattern[j + 1] == '-' && pattern[j + 2] != ']') {
+                        hi = static_cast<unsigned char>(pattern[j + 2]);
+                        j += 2;
+                    }
+                    for (unsigned c = lo; c <= hi; ++c) state.set.set(c);
+                }
+                if (negate) state.set.flip();
+                i = j;
+            } else {
+                if (ch == '\\' && i + 1 < pattern.size()) ch = pattern[++i];
+                state.c = ch;
+            }
+            glob.states.push_back(state);
+        }
+        GlobState accept;
+        accept.kind = GlobState::Accept;
+        glob.states.push_back(accept);
+        return glob;
+    }
+
+    struct TrieNode {
+        std::unordered_map<std::string, std::unique_ptr<TrieNode>> children;
+        bool terminal = false;
+        bool dirOnly = false;
+    };
+
+    struct SuffixRule {
+        std::string suffix;
+        bool dirOnly;
+    };
+
+    struct CompiledRules {
+        TrieNode anchoredPaths;                                       // "build/out", "/bin"
+        std::unordered_map<std::string, bool> names;                  // "node_modules"
+        std::unordered_map<std::string, std::vector<SuffixRule>> suffixes;  // "*.o"
+        std::vector<Glob> globs;                                      // everything else
+    };
+
+    bool hasWildcard(const std::string& pattern) {
+        return pattern.find_first_of("*?[\\") != std::string::npos;
+    }
+
+    void addRule(CompiledRules& rules, std::string pattern) {
+        bool dirOnly = false;
+        while (!pattern.empty() && pattern.back() == '/') {
+            pattern.pop_back();
+            dirOnly = true;
+        }
+        if (pattern.empty()) return;
+
+        // A slash anywhere but the end anchors the rule to the repository root
+        bool anchored = pattern.find('/') != std::string::npos;
+        if (pattern[0] == '/') pattern.erase(0, 1);
+        if (pattern.rfind("**/", 0) == 0 && pattern.find('/', 3) == std::string::npos) {
+            pattern.erase(0, 3);
+            anchored = false;
+        }
+
+        if (!hasWildcard(pattern)) {
+            if (!anchored) {
+                auto it = rules.names.find(pattern);
+                rules.names[pattern] = (it == rules.names.end() || it->second) && dirOnly;
+                return;
+            }
+            TrieNode* node = &rules.anchoredPaths;
+            size_t start = 0;
+            while (start <= pattern.size()) {
+                size_t slash = pattern.find('/', start);
+                std::string part = pattern.substr(start, slash == std::string::npos ? std::string::npos : slash - start);
+                auto& child = node->children[part];
+                if (!child) child = std::make_unique<TrieNode>();
+                node = child.get();
+                if (slash == std::string::npos) break;
+                start = slash + 1;
+            }
+            node->dirOnly = node->terminal ? node->dirOnly && dirOnly : dirOnly;
+            node->terminal = true;
+            return;
+        }
+
+        // "*.ext" style rules: index by the final extension, verify the suffix
+        if (!anchored && pattern[0] == '*' && !hasWildcard(pattern.substr(1))) {
+            std::string suffix = pattern.substr(1);
+            size_t dot = suffix.rfind('.');
+            if (dot != std::string::npos) {
+                rules.suffixes[suffix.substr(dot + 1)].push_back({suffix, dirOnly});
+                return;
+            }
+        }
+
+        Glob glob = compileGlob(pattern);
+        glob.anchored = anchored;
+        glob.dirOnly = dirOnly;
+        rules.globs.push_back(std::move(glob));
+    }
+
+    const CompiledRules& loadedRules() {
+        static const std::unique_ptr<CompiledRules> rules = [] {
+            auto compiled = std::make_unique<CompiledRules>();
+            std::ifstream file(Constants::IGNORE_FILE);
+            std::string line;
+            while (std::getline(file, line)) {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                while (!line.empty() && line.back() == ' ') line.pop_back();
+                if (line.empty() || line[0] == '#' || line[0] == '!') continue;
+                addRule(*compiled, line);
+            }
+            return compiled;
+        }();
+        return *rules;
+    }
+}
+
+// Check a repository-relative path against the ignore rules. Unanchored rules
+// only test the last component, so walkers must prune ignored parents first.
+bool IgnoreRules::isIgnored(const std::string& path, bool isDirectory) {
+    size_t lastSlash = path.rfind('/');
+    std::string_view name = lastSlash == std::string::npos
+        ? std::string_view(path) : std::string_view(path).substr(lastSlash + 1);
+
+    if (name == Constants::GIT_DIR || name == ".git") return true;
+
+    const CompiledRules& rules = loadedRules();
+
+    // Anchored literal paths: walk the trie one component at a time
+    const TrieNode* node = &rules.anchoredPaths;
+    size_t start = 0;
+    while (!node->children.empty()) {
+        size_t slash = path.find('/', start);
+        auto it = node->children.find(path.substr(start, slash == std::string::npos ? std::string::npos : slash - start));
+        if (it == node->children.end()) break;
+        node = it->second.get();
+        if (slash == std::string::npos) {
+            if (node->terminal && (!node->dirOnly || isDirectory)) return true;
+            break;
+        }
+        if (node->terminal) return true;  // an ignored ancestor directory
+        start = slash + 1;
+    }
+
+    auto named = rules.names.find(std::string(name));
+    if (named != rules.names.end() && (!named->second || isDirectory)) return true;
+
+    size_t dot = name.rfind('.');
+    if (dot != std::string_view::npos) {
+        auto bucket = rules.suffixes.find(std::string(name.substr(dot + 1)));
+        if (bucket != rules.suffixes.end()) {
+            for (const auto& rule : bucket->second) {
+                if ((!rule.dirOnly || isDirectory) && name.size() >= rule.suffix.size() &&
+                    name.substr(name.size() - rule.suffix.size()) == rule.suffix) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    for (const auto& glob : rules.globs) {
+        if (glob.dirOnly && !isDirectory) continue;
+        if (glob.matches(glob.anchored ? std::string_view(path) : name)) return true;
+    }
+    return false;
+}
+
+} // namespace MiniGit
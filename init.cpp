@@ -24,8 +24,7 @@ bool Initializer::initializeRepository() {
         Utils::writeObject(initialCommit, commitContent);
         
         // Set up branch references
-        Utils::writeFile(Constants::GIT_DIR + "/refs/heads/main", initialCommit);
-        Utils::writeFile(Constants::BRANCHES_FILE, "main\n");
+        RefStore::writeRef("refs/heads/main", initialCommit);
         Utils::writeFile(Constants::HEAD_FILE, "ref: refs/heads/main");
 
         std::cout << "Initialized empty MiniGit repository with 'main' branch\n";
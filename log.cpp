@@ -1,60 +1,384 @@
 #include "minigit.hpp"
 #include <iostream>
 #include <fstream>
+#include <queue>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
 
 namespace MiniGit {
 
-// Display commit history
-void Logger::showLog() {
-    std::string currentBranch = BranchManager::getCurrentBranch();
-    std::string currentCommit = Utils::readFile(Constants::GIT_DIR + "/refs/heads/" + currentBranch);
+namespace {
+    const size_t FIRST_FLUSH = 4 * 1024;         // first page goes out at once
+    const size_t MAX_BUFFER = 1024 * 1024;       // then the buffer doubles up to this
 
-    if (currentCommit.empty()) {
-        std::cout << "No commits yet\n";
-        return;
-    }
-
-    // Walk commit history backwards
-    while (!currentCommit.empty()) {
-        std::string commitPath = Constants::GIT_DIR + "/objects/" + 
-                               currentCommit.substr(0, 2) + "/" + 
-                               currentCommit.substr(2);
-        
-        // Read commit metadata
-        std::string content = Utils::readFile(commitPath);
-        std::istringstream iss(content);
-        std::string line;
-        std::string message, timestamp, parent;
-
-        while (std::getline(iss, line)) {
-            if (line.substr(0, 8) == "message ") {
-                message = line.substr(8);
-                if (message.find("Merge branch") != std::string::npos) {
-                    message += " (merge)";
-                }
+    // Exact check behind a Bloom filter hit: did the commit change path
+    // itself or anything below it?
+    bool touchesPath(const std::string& commitHash, const std::string& path) {
+        for (const auto& changed : CommitGraph::changedPaths(commitHash)) {
+            if (changed == path ||
+                (changed.size() > path.size() && changed.compare(0, path.size(), path) == 0 &&
+                 changed[path.size()] == '/')) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The commit's message line, without parsing its file list
+    std::string readMessage(const std::string& commitHash) {
+        ObjectView commit = Utils::readObject(commitHash);
+        std::string_view content = commit.view();
+        while (!content.empty()) {
+            size_t eol = content.find('\n');
+            std::string_view line = content.substr(0, eol);
+            if (line.rfind("message ", 0) == 0) return std::string(line.substr(8));
+            if (line.rfind("file ", 0) == 0 || eol == std::string_view::npos) break;
+            content.remove_prefix(eol + 1);
+        }
+        return "";
+    }
+
+    // Days since 1970-01-01 for a proleptic Gregorian date, and back
+    long long daysFromCivil(long long y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        long long era = (y >= 0 ? y : y - 399) / 400;
+        unsigned yoe = static_cast<unsigned>(y - era * 400);
+        unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<long long>(doe) - 719468;
+    }
+
+    void civilFromDays(long long z, long long& y, unsigned& m, unsigned& d) {
+        z += 719468;
+        long long era = (z >= 0 ? z : z - 146096) / 146097;
+        unsigned doe = static_cast<unsigned>(z - era * 146097);
+        unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        unsigned mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = static_cast<long long>(yoe) + era * 400 + (m <= 2);
+    }
+
+    // Local-time formatting without a localtime() call per commit: the UTC
+    // offset is looked up once per hour of history and the calendar fields
+    // are computed arithmetically
+    class DateFormatter {
+    public:
+        struct Fields {
+            long long year;
+            unsigned month, day, weekday, hour, minute, second;
+            long offset;  // seconds east of UTC
+        };
+
+        Fields fields(std::time_t time) {
+            long long hour = floorDiv(static_cast<long long>(time), 3600);
+            if (hour != cachedHour) {
+                std::tm local{};
+#ifdef _WIN32
+                localtime_s(&local, &time);
+#else
+                localtime_r(&time, &local);
+#endif
+                long long localSeconds = daysFromCivil(local.tm_year + 1900LL, local.tm_mon + 1, local.tm_mday) * 86400 +
+                                         local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+                cachedOffset = static_cast<long>(localSeconds - static_cast<long long>(time));
+                cachedHour = hour;
+            }
+
+            long long local = static_cast<long long>(time) + cachedOffset;
+            long long days = floorDiv(local, 86400);
+            long long secondsOfDay = local - days * 86400;
+            Fields f{};
+            civilFromDays(days, f.year, f.month, f.day);
+            f.weekday = static_cast<unsigned>(((days % 7) + 11) % 7);  // 1970-01-01 was a Thursday
+            f.hour = static_cast<unsigned>(secondsOfDay / 3600);
+            f.minute = static_cast<unsigned>(secondsOfDay / 60 % 60);
+            f.second = static_cast<unsigned>(secondsOfDay % 60);
+            f.offset = cachedOffset;
+            return f;
+        }
+
+        // Same layout as strftime's "%c" in the C locale
+        std::string standard(std::time_t time) {
+            static const char* const weekdays[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+            static const char* const months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                                 "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+            Fields f = fields(time);
+            char text[64];
+            std::snprintf(text, sizeof(text), "%s %s %2u %02u:%02u:%02u %lld", weekdays[f.weekday],
+                          months[f.month - 1], f.day, f.hour, f.minute, f.second, f.year);
+            return text;
+        }
+
+        std::string shortDate(std::time_t time) {
+            Fields f = fields(time);
+            char text[32];
+            std::snprintf(text, sizeof(text), "%04lld-%02u-%02u", f.year, f.month, f.day);
+            return text;
+        }
+
+        std::string iso(std::time_t time) {
+            Fields f = fields(time);
+            long offset = f.offset < 0 ? -f.offset : f.offset;
+            char text[64];
+            std::snprintf(text, sizeof(text), "%04lld-%02u-%02u %02u:%02u:%02u %c%02ld%02ld", f.year, f.month,
+                          f.day, f.hour, f.minute, f.second, f.offset < 0 ? '-' : '+', offset / 3600,
+                          offset / 60 % 60);
+            return text;
+        }
+
+    private:
+        static long long floorDiv(long long a, long long b) {
+            return a / b - (a % b != 0 && (a < 0) != (b < 0));
+        }
+
+        long long cachedHour = -1;
+        long cachedOffset = 0;
+    };
+
+    // Collects output and hands it to std::cout in large writes. The first
+    // flush happens after a few KiB so the first screen appears immediately.
+    class OutputBuffer {
+    public:
+        ~OutputBuffer() { flush(); }
+
+        void append(const std::string& text) {
+            data += text;
+            if (data.size() >= threshold) {
+                flush();
+                threshold = std::min(threshold * 2, MAX_BUFFER);
+            }
+        }
+
+        void flush() {
+            if (data.empty()) return;
+            std::cout.write(data.data(), static_cast<std::streamsize>(data.size()));
+            std::cout.flush();
+            data.clear();
+        }
+
+    private:
+        std::string data;
+        size_t threshold = FIRST_FLUSH;
+    };
+
+    // Expand a --format string for one commit. Placeholders: %H %h (hash),
+    // %P %p (parents), %s (subject), %d (branch), %ad %as %ai %at (date),
+    // %n and %%.
+    std::string expandFormat(const std::string& format, const std::string& hash, const CommitGraph::Entry& entry,
+                             const std::string& message, const std::string& branch, DateFormatter& dates) {
+        std::string out;
+        for (size_t i = 0; i < format.size(); ++i) {
+            if (format[i] != '%' || i + 1 == format.size()) {
+                out += format[i];
+                continue;
+            }
+            char code = format[++i];
+            switch (code) {
+                case 'H': out += hash; break;
+                case 'h': out += hash.substr(0, 7); break;
+                case 'P':
+                case 'p':
+                    for (size_t p = 0; p < entry.parents.size(); ++p) {
+                        if (p) out += ' ';
+                        out += code == 'P' ? entry.parents[p] : entry.parents[p].substr(0, 7);
+                    }
+                    break;
+                case 's': out += message; break;
+                case 'd': out += branch; break;
+                case 'n': out += '\n'; break;
+                case '%': out += '%'; break;
+                case 'a':
+                case 'c':
+                    if (i + 1 < format.size()) {
+                        char style = format[++i];
+                        if (style == 'd') out += dates.standard(entry.time);
+                        else if (style == 's') out += dates.shortDate(entry.time);
+                        else if (style == 'i') out += dates.iso(entry.time);
+                        else if (style == 't') out += std::to_string(entry.time);
+                        else out += std::string("%") + code + style;
+                        break;
+                    }
+                    out += std::string("%") + code;
+                    break;
+                default:
+                    out += '%';
+                    out += code;
             }
-            else if (line.substr(0, 5) == "time ") timestamp = line.substr(5);
-            else if (line.substr(0, 7) == "parent ") parent = line.substr(7);
         }
+        return out;
+    }
+
+    std::string readBranch(const std::string& commitHash) {
+        CommitInfo commit;
+        Utils::readCommit(commitHash, commit);
+        return commit.branch;
+    }
+}
+
+// Parse a --since value: seconds since the epoch, "YYYY-MM-DD[ HH:MM[:SS]]"
+// in local time, or "<N> <unit>[s] ago" / "N.units.ago"
+bool Logger::parseDate(const std::string& text, std::time_t& result) {
+    std::string value = text;
+    for (char& ch : value) {
+        if (ch == '.' || ch == '_') ch = ' ';
+    }
+
+    int year, month, day, hour = 0, minute = 0, second = 0;
+    if (std::sscanf(value.c_str(), "%d-%d-%d %d:%d:%d", &year, &month, &day, &hour, &minute, &second) >= 3) {
+        std::tm local{};
+        local.tm_year = year - 1900;
+        local.tm_mon = month - 1;
+        local.tm_mday = day;
+        local.tm_hour = hour;
+        local.tm_min = minute;
+        local.tm_sec = second;
+        local.tm_isdst = -1;
+        result = std::mktime(&local);
+        return result != -1;
+    }
+
+    long long amount = 0;
+    char unit[32] = {};
+    char ago[8] = {};
+    int parsed = std::sscanf(value.c_str(), "%lld %31s %7s", &amount, unit, ago);
+    if (parsed == 1 && value.find_first_not_of("0123456789") == std::string::npos) {
+        result = static_cast<std::time_t>(amount);
+        return true;
+    }
+    if (parsed != 3 || std::string(ago) != "ago") return false;
 
-    
-        if (timestamp.empty()) {
-            std::cerr << "Warning: Missing timestamp in commit " << currentCommit << "\n";
-            timestamp = "0"; // default to epoch time if missing
+    std::string name = unit;
+    if (name.size() > 1 && name.back() == 's') name.pop_back();
+    static const std::pair<const char*, long long> units[] = {
+        {"second", 1}, {"minute", 60}, {"hour", 3600}, {"day", 86400},
+        {"week", 7 * 86400}, {"month", 30 * 86400}, {"year", 365 * 86400}};
+    for (const auto& [unitName, seconds] : units) {
+        if (name == unitName) {
+            result = std::time(nullptr) - static_cast<std::time_t>(amount * seconds);
+            return true;
         }
-        
+    }
+    return false;
+}
 
-        // Format timestamp
-        std::time_t time = std::stol(timestamp);
-        char timeStr[100];
-        std::strftime(timeStr, sizeof(timeStr), "%c", std::localtime(&time));
+// Display commit history, walking every parent from the starting tips.
+// Commits come off a priority queue (newest first, or highest generation
+// first for topological order, which never shows a parent before its
+// children), so output streams as the walk proceeds and stops as soon as
+// maxCount commits have been shown. With follow, a file path is traced
+// back across the commits that renamed it.
+bool Logger::showLog(const Options& options) {
+    std::vector<std::string> tips;
+    for (const auto& revision : options.revisions) {
+        std::string hash = RefStore::resolve(revision);
+        if (hash.empty()) {
+            std::cerr << "Error: Unknown revision " << revision << "\n";
+            return false;
+        }
+        tips.push_back(hash);
+    }
+    if (options.all) {
+        for (const auto& [name, hash] : RefStore::listRefs("refs/")) tips.push_back(hash);
+    }
+    if (options.revisions.empty()) tips.push_back(RefStore::resolveHead());
+    tips.erase(std::remove(tips.begin(), tips.end(), std::string()), tips.end());
+
+    if (tips.empty()) {
+        std::cout << "No commits yet\n";
+        return true;
+    }
 
-        // Print commit info
-        std::cout << "commit " << currentCommit << "\n"
-                  << "Date:   " << timeStr << "\n"
-                  << "\n    " << message << "\n\n";
+    std::string filter = options.path;
+    while (!filter.empty() && filter.back() == '/') filter.pop_back();
+    if (filter.rfind("./", 0) == 0) filter.erase(0, 2);
 
-        currentCommit = parent; // Move to parent commit
+    struct Queued {
+        uint64_t primary;
+        uint64_t secondary;
+        std::string hash;
+        const CommitGraph::Entry* entry;
+        bool operator<(const Queued& other) const {
+            return primary != other.primary ? primary < other.primary : secondary < other.secondary;
+        }
+    };
+    std::priority_queue<Queued> queue;
+    std::unordered_set<std::string> seen;
+    auto enqueue = [&](const std::string& hash) {
+        if (hash.empty() || !seen.insert(hash).second) return;
+        const CommitGraph::Entry* entry = CommitGraph::lookup(hash);
+        if (!entry) {
+            std::cerr << "Warning: Missing commit " << hash << "\n";
+            return;
+        }
+        uint64_t time = static_cast<uint64_t>(std::max<std::time_t>(entry->time, 0));
+        if (options.order == Order::Topo) {
+            queue.push({entry->generation, time, hash, entry});
+        } else {
+            queue.push({time, entry->generation, hash, entry});
+        }
+    };
+    for (const auto& tip : tips) enqueue(tip);
+
+    OutputBuffer out;
+    DateFormatter dates;
+    long shown = 0;
+    while (!queue.empty() && (options.maxCount < 0 || shown < options.maxCount)) {
+        Queued next = queue.top();
+        queue.pop();
+        const std::string& currentCommit = next.hash;
+        const CommitGraph::Entry& entry = *next.entry;
+
+        // Parents are older than their children, so history beyond an
+        // old-enough commit is not walked at all
+        if (options.since && entry.time < options.since) continue;
+        for (const auto& parent : entry.parents) enqueue(parent);
+
+        // Most commits are rejected by the filter without opening any object
+        if (!filter.empty() &&
+            (!CommitGraph::mayChangePath(entry, filter) || !touchesPath(currentCommit, filter))) {
+            continue;
+        }
+
+        std::string message = readMessage(currentCommit);
+        if (!options.format.empty()) {
+            std::string branch = options.format.find("%d") != std::string::npos ? readBranch(currentCommit) : "";
+            out.append(expandFormat(options.format, currentCommit, entry, message, branch, dates) + "\n");
+        } else {
+            if (message.find("Merge branch") != std::string::npos) {
+                message += " (merge)";
+            }
+            if (entry.time == 0) {
+                std::cerr << "Warning: Missing timestamp in commit " << currentCommit << "\n";
+            }
+            out.append("commit " + currentCommit + "\n" +
+                       "Date:   " + dates.standard(entry.time) + "\n" +
+                       "\n    " + message + "\n\n");
+        }
+
+        // A commit that added the followed file may have renamed it; only
+        // then are the two full file lists needed
+        std::string parent = entry.parents.empty() ? "" : entry.parents.front();
+        if (options.follow && !filter.empty() && !parent.empty() &&
+            !MergeManager::getCommitFile(currentCommit, filter).empty() &&
+            MergeManager::getCommitFile(parent, filter).empty()) {
+            auto files = MergeManager::getCommitFiles(currentCommit);
+            auto parentFiles = MergeManager::getCommitFiles(parent);
+            for (const auto& rename : RenameDetector::detect(parentFiles, files)) {
+                if (rename.to == filter) {
+                    filter = rename.from;
+                    break;
+                }
+            }
+        }
+
+        ++shown;
     }
+    out.flush();
+
+    CommitGraph::save();
+    return true;
 }
-} // namespace MiniGit
\ No newline at end of file
+} // namespace MiniGit
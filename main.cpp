@@ -4,6 +4,9 @@
 #include <algorithm>
 #include <filesystem>
 #include <regex>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 
 // Helper: Validate SHA1 commit hash format
 bool isValidCommitHash(const std::string& hash) {
@@ -11,18 +14,50 @@ bool isValidCommitHash(const std::string& hash) {
     return std::regex_match(hash, sha1_regex);
 }
 
+// Helper: Parse a non-negative count, rejecting trailing garbage ("5x")
+bool parseCount(const std::string& text, long& count) {
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) return false;
+    char* end = nullptr;
+    errno = 0;
+    count = std::strtol(text.c_str(), &end, 10);
+    return errno == 0 && *end == '\0';
+}
+
 // Print help menu
 void showHelp() {
     std::cout << "MiniGit - A minimal Git implementation\n\n"
               << "Usage: minigit <command> [<args>]\n\n"
               << "Commands:\n"
               << "  init                     Initialize new repository\n"
-              << "  add <file> [<file2>...]  Add files to staging\n"
+              << "  add <file|dir> [...]     Add files (directories recursively) to staging\n"
+              << "  status                   Show staged, modified and untracked files\n"
               << "  commit  -m \"<message>\" Commit staged changes\n"
-              << "  log                      Show commit history\n"
+              << "  log [-n N] [--since <date>] [--oneline|--format=<fmt>] [--all]\n"
+              << "      [--topo-order] [--follow] [<revision>...] [-- <path>]\n"
+              << "                           Show commit history (optionally for one path)\n"
+              << "  diff [-C] <from> [<to>]  List changed paths, with renames (and copies)\n"
+              << "  archive [--gzip] [-o <file>] [<commit>]\n"
+              << "                           Write a tar of a commit to stdout or a file\n"
+              << "  grep [-i] <pattern> [<commit>]\n"
+              << "                           Search file contents of a commit\n"
+              << "  blame <file>             Show the commit that last changed each line\n"
               << "  branch [<name>]          List/create branches\n"
+              << "  branch -d <name>         Delete a branch\n"
               << "  checkout <branch|commit> Switch branches or checkout commit (detached HEAD)\n"
               << "  merge <branch>           Merge branches\n"
+              << "  sparse-checkout set <dir>... | list | disable\n"
+              << "                           Limit the working tree to directory cones\n"
+              << "  fast-import              Import commits from a fast-import stream on stdin\n"
+              << "  clone <path> <dir>       Copy another repository\n"
+              << "  fetch [<remote|path>]    Fetch missing objects and remote branches\n"
+              << "  push [<remote|path> [<branch>]]\n"
+              << "                           Send a branch to another repository (fast-forward only)\n"
+              << "  fsmonitor start|stop|status\n"
+              << "                           Watch the working tree so status need not scan it\n"
+              << "  fsck                     Verify object hashes and commit structure\n"
+              << "  pack-refs                Pack loose refs into .minigit/packed-refs\n"
+              << "  prune [--expire <s>|--now] [-n]\n"
+              << "                           Delete unreachable objects older than the grace period\n"
               << "  help                     Show this help\n";
 }
 
@@ -57,6 +92,11 @@ int main(int argc, char* argv[]) {
             if (!allSucceeded) return 1;
         }
 
+        // Command: status
+        else if (command == "status" && argc == 2) {
+            if (!MiniGit::WorkingTree::showStatus()) return 1;
+        }
+
         // Command: commit [-a] -m "message"
         else if (command == "commit") {
             std::string message;
@@ -90,7 +130,108 @@ int main(int argc, char* argv[]) {
 
         // Command: log
         else if (command == "log") {
-            MiniGit::Logger::showLog();
+            MiniGit::Logger::Options options;
+            auto usage = [] {
+                std::cerr << "Usage: minigit log [-n <count>] [--since <date>] [--oneline | --format=<fmt>]\n"
+                          << "                   [--all] [--topo-order | --date-order] [--follow]\n"
+                          << "                   [<revision>...] [-- <path>]\n";
+                return 1;
+            };
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if ((arg == "-n" || arg == "--max-count") && i + 1 < argc) {
+                    if (!parseCount(argv[++i], options.maxCount)) return usage();
+                } else if (arg.size() > 1 && arg[0] == '-' && std::isdigit(static_cast<unsigned char>(arg[1]))) {
+                    if (!parseCount(arg.substr(1), options.maxCount)) return usage();
+                } else if (arg == "--since" || arg == "--after" || arg.rfind("--since=", 0) == 0 ||
+                           arg.rfind("--after=", 0) == 0) {
+                    size_t eq = arg.find('=');
+                    if (eq == std::string::npos && i + 1 == argc) return usage();
+                    std::string value = eq == std::string::npos ? argv[++i] : arg.substr(eq + 1);
+                    if (!MiniGit::Logger::parseDate(value, options.since)) {
+                        std::cerr << "Error: Invalid date '" << value << "'\n";
+                        return 1;
+                    }
+                } else if (arg == "--oneline") {
+                    options.format = "%h %s";
+                } else if (arg.rfind("--format=", 0) == 0 || arg.rfind("--pretty=", 0) == 0) {
+                    std::string format = arg.substr(arg.find('=') + 1);
+                    if (format.rfind("format:", 0) == 0) format = format.substr(7);
+                    if (format == "oneline") format = "%H %s";
+                    else if (format == "medium") format.clear();
+                    options.format = format;
+                } else if (arg == "--all") {
+                    options.all = true;
+                } else if (arg == "--topo-order") {
+                    options.order = MiniGit::Logger::Order::Topo;
+                } else if (arg == "--date-order") {
+                    options.order = MiniGit::Logger::Order::Date;
+                } else if (arg == "--follow") {
+                    options.follow = true;
+                } else if (arg == "--" && i + 1 < argc) {
+                    options.path = argv[++i];
+                } else if (!arg.empty() && arg[0] != '-') {
+                    options.revisions.push_back(arg);
+                } else {
+                    return usage();
+                }
+            }
+            if (!MiniGit::Logger::showLog(options)) return 1;
+        }
+
+        // Command: diff [-C] <from> [<to>]
+        else if (command == "diff") {
+            bool copies = argc > 2 && std::string(argv[2]) == "-C";
+            int first = copies ? 3 : 2;
+            if (argc - first < 1 || argc - first > 2) {
+                std::cerr << "Usage: minigit diff [-C] <from> [<to>]\n";
+                return 1;
+            }
+            std::string to = argc - first == 2 ? argv[first + 1] : "HEAD";
+            if (!MiniGit::Differ::showNameStatus(argv[first], to, copies)) return 1;
+        }
+
+        // Command: grep [-i] <pattern> [<commit>]
+        else if (command == "grep") {
+            bool ignoreCase = argc > 2 && std::string(argv[2]) == "-i";
+            int first = ignoreCase ? 3 : 2;
+            if (argc - first < 1 || argc - first > 2) {
+                std::cerr << "Usage: minigit grep [-i] <pattern> [<commit>]\n";
+                return 1;
+            }
+            if (!MiniGit::Grepper::grep(argv[first], argc - first == 2 ? argv[first + 1] : "", ignoreCase)) {
+                return 1;
+            }
+        }
+
+        // Command: archive [--gzip] [-o <file>] [<commit>]
+        else if (command == "archive") {
+            std::string revision, output;
+            bool gzip = false;
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "-o" && i + 1 < argc) {
+                    output = argv[++i];
+                } else if (arg == "--gzip") {
+                    gzip = true;
+                } else if (revision.empty() && arg[0] != '-') {
+                    revision = arg;
+                } else {
+                    std::cerr << "Usage: minigit archive [--gzip] [-o <file>] [<commit>]\n";
+                    return 1;
+                }
+            }
+            auto endsWith = [&](const std::string& suffix) {
+                return output.size() >= suffix.size() &&
+                       output.compare(output.size() - suffix.size(), suffix.size(), suffix) == 0;
+            };
+            gzip = gzip || endsWith(".tar.gz") || endsWith(".tgz");
+            if (!MiniGit::Archiver::writeArchive(revision, output, gzip)) return 1;
+        }
+
+        // Command: blame <file>
+        else if (command == "blame" && argc == 3) {
+            if (!MiniGit::Blamer::blameFile(argv[2])) return 1;
         }
 
         // Command: branch or branch <name>
@@ -101,6 +242,8 @@ int main(int argc, char* argv[]) {
                 for (const auto& branch : branches) {
                     std::cout << (branch == current ? "* " : "  ") << branch << "\n";
                 }
+            } else if (argc == 4 && (std::string(argv[2]) == "-d" || std::string(argv[2]) == "--delete")) {
+                if (!MiniGit::BranchManager::deleteBranch(argv[3])) return 1;
             } else if (argc == 3) {
                 if (!MiniGit::BranchManager::createBranch(argv[2])) return 1;
             } else {
@@ -113,7 +256,7 @@ int main(int argc, char* argv[]) {
         else if (command == "checkout" && argc == 3) {
             std::string target = argv[2];
             if (MiniGit::BranchManager::branchExists(target)) {
-                std::string commitHash = MiniGit::Utils::readFile(MiniGit::Constants::GIT_DIR + "/refs/heads/" + target);
+                std::string commitHash = MiniGit::RefStore::readRef("refs/heads/" + target);
                 if (!MiniGit::CheckoutManager::checkoutCommit(commitHash, target)) return 1;
             } else {
                 std::string objPath = MiniGit::Constants::GIT_DIR + "/objects/" + target.substr(0, 2) + "/" + target.substr(2);
@@ -140,6 +283,97 @@ int main(int argc, char* argv[]) {
             }
         }
 
+        // Command: sparse-checkout set <dir>... | list | disable
+        else if (command == "sparse-checkout" && argc >= 3) {
+            std::string action = argv[2];
+            if (action == "list" && argc == 3) {
+                for (const auto& cone : MiniGit::SparseCheckout::getPatterns()) {
+                    std::cout << cone << "\n";
+                }
+                return 0;
+            }
+
+            if (action == "set" && argc >= 4) {
+                std::vector<std::string> cones(argv + 3, argv + argc);
+                if (!MiniGit::SparseCheckout::setPatterns(cones)) return 1;
+            } else if (action == "disable" && argc == 3) {
+                if (!MiniGit::SparseCheckout::disable()) return 1;
+            } else {
+                std::cerr << "Usage: minigit sparse-checkout set <dir>... | list | disable\n";
+                return 1;
+            }
+
+            // Re-apply the new cones to the current HEAD
+            std::string branch = MiniGit::BranchManager::getCurrentBranch();
+            std::string commitHash = MiniGit::RefStore::resolveHead();
+            if (!MiniGit::CheckoutManager::checkoutCommit(commitHash, branch)) return 1;
+        }
+
+        // Command: clone <path> <directory>
+        else if (command == "clone" && argc == 4) {
+            if (!MiniGit::RemoteManager::clone(argv[2], argv[3])) return 1;
+        }
+
+        // Command: fetch [<remote|path>]
+        else if (command == "fetch" && argc <= 3) {
+            if (!MiniGit::RemoteManager::fetch(argc == 3 ? argv[2] : "")) return 1;
+        }
+
+        // Command: push [<remote|path> [<branch>]]
+        else if (command == "push" && argc <= 4) {
+            if (!MiniGit::RemoteManager::push(argc >= 3 ? argv[2] : "", argc == 4 ? argv[3] : "")) return 1;
+        }
+
+        // Command: fast-import (stream on stdin)
+        else if (command == "fast-import" && argc == 2) {
+            if (!MiniGit::FastImporter::run(std::cin)) return 1;
+        }
+
+        // Command: fsmonitor start|stop|status
+        else if (command == "fsmonitor" && argc == 3) {
+            std::string action = argv[2];
+            if (action == "start") {
+                if (!MiniGit::FsMonitor::start()) return 1;
+            } else if (action == "stop") {
+                if (!MiniGit::FsMonitor::stop()) return 1;
+            } else if (action == "status") {
+                std::cout << "fsmonitor is " << (MiniGit::FsMonitor::isRunning() ? "" : "not ") << "running\n";
+            } else {
+                std::cerr << "Usage: minigit fsmonitor start|stop|status\n";
+                return 1;
+            }
+        }
+
+        // Command: prune [--expire <seconds>|--now] [-n]
+        else if (command == "prune") {
+            long expire = MiniGit::Pruner::DEFAULT_EXPIRE_SECONDS;
+            bool dryRun = false;
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--expire" && i + 1 < argc && parseCount(argv[i + 1], expire)) {
+                    ++i;
+                } else if (arg == "--now") {
+                    expire = 0;
+                } else if (arg == "-n" || arg == "--dry-run") {
+                    dryRun = true;
+                } else {
+                    std::cerr << "Usage: minigit prune [--expire <seconds>|--now] [-n]\n";
+                    return 1;
+                }
+            }
+            if (!MiniGit::Pruner::prune(expire, dryRun)) return 1;
+        }
+
+        // Command: fsck
+        else if (command == "fsck" && argc == 2) {
+            if (!MiniGit::IntegrityChecker::fsck()) return 1;
+        }
+
+        // Command: pack-refs
+        else if (command == "pack-refs" && argc == 2) {
+            if (!MiniGit::RefStore::packRefs()) return 1;
+        }
+
         // Unknown command
         else {
             std::cerr << "Error: Unknown command '" << command << "'\n";
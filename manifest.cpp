@@ -0,0 +1,351 @@
+#include "minigit.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+namespace MiniGit {
+
+namespace {
+    const size_t LEAF_MAX = 32;      // a subtree this small is stored as one leaf
+    const unsigned SLOT_BITS = 5;    // 32 children per inner node
+    const unsigned MAX_DEPTH = 12;   // 60 bits of the path hash; deeper entries share a leaf
+    const std::string LEAF_HEADER = "manifest-leaf\n";
+    const std::string NODE_HEADER = "manifest-node\n";
+
+    struct Entry {
+        std::string path;
+        std::string hash;  // empty in a change list: remove path
+        uint64_t key;
+    };
+
+    struct Child {
+        unsigned slot;
+        size_t count;
+        std::string hash;
+    };
+
+    // A parsed node: either a leaf of files or up to 32 children
+    struct Node {
+        bool leaf = true;
+        std::vector<std::pair<std::string, std::string>> files;
+        std::vector<Child> children;
+    };
+
+    struct Built {
+        std::string hash;
+        size_t count;
+    };
+
+    uint64_t pathKey(std::string_view path) {
+        return Utils::mix(Utils::fnv1a(path));
+    }
+
+    unsigned slotOf(uint64_t key, unsigned depth) {
+        return static_cast<unsigned>(key >> (depth * SLOT_BITS)) & ((1u << SLOT_BITS) - 1);
+    }
+
+    // Leaf:  "manifest-leaf", then "file <path> <hash>" sorted by path
+    // Inner: "manifest-node", then "<slot> <count> <hash>" sorted by slot
+    bool parseNode(std::string_view content, Node& node) {
+        bool leaf = content.rfind(LEAF_HEADER, 0) == 0;
+        if (!leaf && content.rfind(NODE_HEADER, 0) != 0) return false;
+        node.leaf = leaf;
+        content.remove_prefix((leaf ? LEAF_HEADER : NODE_HEADER).size());
+
+        while (!content.empty()) {
+            size_t eol = content.find('\n');
+            std::string_view line = content.substr(0, eol);
+            content = eol == std::string_view::npos ? std::string_view() : content.substr(eol + 1);
+            size_t last = line.rfind(' ');
+            if (last == std::string_view::npos) return false;
+
+            if (leaf) {
+                if (line.rfind("file ", 0) != 0 || last < 5) return false;
+                node.files.emplace_back(std::string(line.substr(5, last - 5)), std::string(line.substr(last + 1)));
+            } else {
+                size_t first = line.find(' ');
+                Child child;
+                child.slot = static_cast<unsigned>(std::strtoul(std::string(line.substr(0, first)).c_str(), nullptr, 10));
+                child.count = std::strtoull(std::string(line.substr(first + 1, last - first - 1)).c_str(), nullptr, 10);
+                child.hash = std::string(line.substr(last + 1));
+                node.children.push_back(std::move(child));
+            }
+        }
+        return true;
+    }
+
+    // The empty hash stands for the empty manifest
+    bool loadNode(const std::string& hash, Node& node) {
+        if (hash.empty()) return true;
+        ObjectView object = Utils::readObject(hash);
+        return object.valid() && parseNode(object.view(), node);
+    }
+
+    // Nodes produced by one build or update, written together at the end
+    class NodeWriter {
+    public:
+        std::string store(std::string content) {
+            std::string hash = Utils::computeSHA1(content);
+            pending.emplace_back(hash, std::move(content));
+            return hash;
+        }
+
+        bool flush() {
+            std::atomic<bool> ok{true};
+            Utils::parallelFor(pending.size(), [&](size_t i) {
+                const auto& [hash, content] = pending[i];
+                if (std::filesystem::exists(Utils::objectPath(hash))) return;
+                if (!Utils::writeObject(hash, content)) ok = false;
+            });
+            pending.clear();
+            return ok;
+        }
+
+    private:
+        std::vector<std::pair<std::string, std::string>> pending;
+    };
+
+    // Build the canonical subtree for a set of entries: a leaf when they
+    // fit (or the hash bits run out), otherwise one child per 5-bit slot.
+    // The shape depends only on the contents, never on the edit history.
+    Built build(std::vector<Entry>& entries, unsigned depth, NodeWriter& writer) {
+        if (entries.size() <= LEAF_MAX || depth == MAX_DEPTH) {
+            std::sort(entries.begin(), entries.end(),
+                      [](const Entry& a, const Entry& b) { return a.path < b.path; });
+            std::string content = LEAF_HEADER;
+            for (const auto& entry : entries) content += "file " + entry.path + " " + entry.hash + "\n";
+            return {writer.store(std::move(content)), entries.size()};
+        }
+
+        std::array<std::vector<Entry>, 1u << SLOT_BITS> groups;
+        for (auto& entry : entries) groups[slotOf(entry.key, depth)].push_back(std::move(entry));
+        std::string content = NODE_HEADER;
+        for (unsigned slot = 0; slot < groups.size(); ++slot) {
+            if (groups[slot].empty()) continue;
+            Built child = build(groups[slot], depth + 1, writer);
+            content += std::to_string(slot) + " " + std::to_string(child.count) + " " + child.hash + "\n";
+        }
+        return {writer.store(std::move(content)), entries.size()};
+    }
+
+    // Every file below a node
+    bool collect(const std::string& hash, std::vector<Entry>& out) {
+        Node node;
+        if (!loadNode(hash, node)) return false;
+        for (auto& [path, blob] : node.files) {
+            uint64_t key = pathKey(path);
+            out.push_back({std::move(path), std::move(blob), key});
+        }
+        for (const auto& child : node.children) {
+            if (!collect(child.hash, out)) return false;
+        }
+        return true;
+    }
+
+    // Apply changes (all hashing into this subtree) copy-on-write: only the
+    // nodes on the changed paths are rewritten; every other subtree keeps
+    // its hash and is shared with the old manifest
+    bool apply(const std::string& hash, std::vector<Entry>& changes, unsigned depth,
+               NodeWriter& writer, Built& result) {
+        Node node;
+        if (!loadNode(hash, node)) return false;
+
+        if (node.leaf) {
+            std::map<std::string, std::string> files(std::make_move_iterator(node.files.begin()),
+                                                     std::make_move_iterator(node.files.end()));
+            for (const auto& change : changes) {
+                if (change.hash.empty()) files.erase(change.path);
+                else files[change.path] = change.hash;
+            }
+            std::vector<Entry> entries;
+            entries.reserve(files.size());
+            for (auto& [path, blob] : files) {
+                uint64_t key = pathKey(path);
+                entries.push_back({path, std::move(blob), key});
+            }
+            result = build(entries, depth, writer);
+            return true;
+        }
+
+        std::array<std::vector<Entry>, 1u << SLOT_BITS> groups;
+        for (auto& change : changes) groups[slotOf(change.key, depth)].push_back(std::move(change));
+
+        std::vector<Child> children;
+        size_t total = 0;
+        auto existing = node.children.begin();
+        for (unsigned slot = 0; slot < groups.size(); ++slot) {
+            bool present = existing != node.children.end() && existing->slot == slot;
+            Child child = present ? *existing++ : Child{slot, 0, ""};
+            if (!groups[slot].empty()) {
+                Built updated;
+                if (!apply(child.hash, groups[slot], depth + 1, writer, updated)) return false;
+                child.count = updated.count;
+                child.hash = updated.hash;
+            }
+            if (child.count == 0) continue;
+            total += child.count;
+            children.push_back(std::move(child));
+        }
+
+        // Shrunk below a leaf's size: fold the children back into one leaf
+        if (total <= LEAF_MAX) {
+            std::vector<Entry> entries;
+            for (const auto& child : children) {
+                if (!collect(child.hash, entries)) return false;
+            }
+            result = build(entries, depth, writer);
+            return true;
+        }
+
+        std::string content = NODE_HEADER;
+        for (const auto& child : children) {
+            content += std::to_string(child.slot) + " " + std::to_string(child.count) + " " + child.hash + "\n";
+        }
+        result = {writer.store(std::move(content)), total};
+        return true;
+    }
+
+    using DiffVisitor = std::function<void(const std::string&, const std::string&, const std::string&)>;
+
+    bool diffNodes(const std::string& before, const std::string& after, const DiffVisitor& visit) {
+        if (before == after) return true;  // shared subtree
+        Node left, right;
+        if (!loadNode(before, left) || !loadNode(after, right)) return false;
+
+        if (!before.empty() && !after.empty() && !left.leaf && !right.leaf) {
+            auto a = left.children.begin();
+            auto b = right.children.begin();
+            while (a != left.children.end() || b != right.children.end()) {
+                if (b == right.children.end() || (a != left.children.end() && a->slot < b->slot)) {
+                    if (!diffNodes(a++->hash, "", visit)) return false;
+                } else if (a == left.children.end() || b->slot < a->slot) {
+                    if (!diffNodes("", b++->hash, visit)) return false;
+                } else {
+                    if (!diffNodes(a++->hash, b++->hash, visit)) return false;
+                }
+            }
+            return true;
+        }
+
+        // A leaf on either side: compare the (small) flattened contents
+        std::vector<Entry> oldFiles, newFiles;
+        if (!collect(before, oldFiles) || !collect(after, newFiles)) return false;
+        std::unordered_map<std::string, std::string> remaining;
+        for (auto& entry : oldFiles) remaining.emplace(std::move(entry.path), std::move(entry.hash));
+        for (const auto& entry : newFiles) {
+            auto it = remaining.find(entry.path);
+            if (it == remaining.end()) {
+                visit(entry.path, "", entry.hash);
+                continue;
+            }
+            if (it->second != entry.hash) visit(entry.path, it->second, entry.hash);
+            remaining.erase(it);
+        }
+        for (const auto& [path, hash] : remaining) visit(path, hash, "");
+        return true;
+    }
+}
+
+// Store a whole file list as a new manifest and return its root
+std::string Manifest::write(const std::unordered_map<std::string, std::string>& files) {
+    std::vector<Entry> entries;
+    entries.reserve(files.size());
+    for (const auto& [path, hash] : files) entries.push_back({path, hash, pathKey(path)});
+    NodeWriter writer;
+    Built root = build(entries, 0, writer);
+    return writer.flush() ? root.hash : "";
+}
+
+// New manifest equal to root with changes applied (an empty hash removes
+// the path). Costs O(changes x depth) node writes, whatever the size of the
+// manifest. Returns "" if a node of root cannot be read or written.
+std::string Manifest::update(const std::string& root, const std::unordered_map<std::string, std::string>& changes) {
+    std::vector<Entry> entries;
+    entries.reserve(changes.size());
+    for (const auto& [path, hash] : changes) entries.push_back({path, hash, pathKey(path)});
+    NodeWriter writer;
+    Built result;
+    if (!apply(root, entries, 0, writer, result) || !writer.flush()) return "";
+    return result.hash;
+}
+
+// Every file of a manifest; the root's subtrees are read in parallel.
+// False if any node is missing or damaged (files is then incomplete).
+bool Manifest::read(const std::string& root, std::unordered_map<std::string, std::string>& files) {
+    Node node;
+    if (!loadNode(root, node)) return false;
+
+    std::vector<std::vector<Entry>> parts(node.children.size());
+    std::atomic<bool> ok{true};
+    Utils::parallelFor(node.children.size(), [&](size_t i) {
+        if (!collect(node.children[i].hash, parts[i])) ok = false;
+    });
+    for (auto& [path, hash] : node.files) files.emplace(std::move(path), std::move(hash));
+    for (auto& part : parts) {
+        for (auto& entry : part) files.emplace(std::move(entry.path), std::move(entry.hash));
+    }
+    return ok;
+}
+
+// Blob of one path ("" if absent), reading only the nodes on its hash
+// path: O(depth) objects rather than the whole manifest
+std::string Manifest::lookup(const std::string& root, const std::string& path) {
+    uint64_t key = pathKey(path);
+    std::string hash = root;
+    for (unsigned depth = 0;; ++depth) {
+        Node node;
+        if (!loadNode(hash, node)) return "";
+        if (node.leaf) {
+            auto file = std::lower_bound(node.files.begin(), node.files.end(), path,
+                                         [](const auto& entry, const std::string& p) { return entry.first < p; });
+            return file != node.files.end() && file->first == path ? file->second : "";
+        }
+        unsigned slot = slotOf(key, depth);
+        auto child = std::find_if(node.children.begin(), node.children.end(),
+                                  [slot](const Child& c) { return c.slot == slot; });
+        if (child == node.children.end()) return "";
+        hash = child->hash;
+    }
+}
+
+// Report every path whose blob differs between two manifests as
+// (path, old hash, new hash), with "" for a missing side. Subtrees the two
+// share are skipped without being read.
+bool Manifest::diff(const std::string& before, const std::string& after,
+                    const std::function<void(const std::string&, const std::string&, const std::string&)>& visit) {
+    return diffNodes(before, after, visit);
+}
+
+// One node's direct references, for reachability walks
+bool Manifest::readNode(const std::string& hash, std::vector<std::string>& nodes,
+                        std::vector<std::pair<std::string, std::string>>& files) {
+    Node node;
+    if (hash.empty() || !loadNode(hash, node)) return false;
+    for (auto& child : node.children) nodes.push_back(std::move(child.hash));
+    for (auto& file : node.files) files.push_back(std::move(file));
+    return true;
+}
+
+// Manifest of a new child of commitHash ("" for no parent): the parent's
+// manifest with changes applied. A parent written before manifests (or a
+// placeholder root) lists its files inline; the child's manifest is then
+// built from that list in the same pass, so no root is stored for the
+// parent itself. Returns "" on failure.
+std::string Manifest::updateCommit(const std::string& commitHash,
+                                   const std::unordered_map<std::string, std::string>& changes) {
+    std::unordered_map<std::string, std::string> files;
+    if (!commitHash.empty()) {
+        CommitInfo commit;
+        if (!Utils::readCommit(commitHash, commit)) return "";
+        if (!commit.manifest.empty()) return update(commit.manifest, changes);
+        for (auto& [path, hash] : commit.files) files[path] = std::move(hash);
+    }
+
+    for (const auto& [path, hash] : changes) {
+        if (hash.empty()) files.erase(path);
+        else files[path] = hash;
+    }
+    return write(files);
+}
+
+} // namespace MiniGit
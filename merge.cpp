@@ -4,72 +4,93 @@
 #include <set>
 #include <algorithm>
 #include <sstream>
+#include <fstream>
 
 namespace MiniGit {
 
+namespace {
+    std::vector<std::string> parentsOf(const std::string& commitHash) {
+        CommitInfo commit;
+        Utils::readCommit(commitHash, commit);
+        return commit.parents;
+    }
+}
+
+// Nearest commit reachable from both, following every parent (not only the
+// first) so that earlier merges are taken into account
 std::string MergeManager::findCommonAncestor(const std::string& commit1, 
                                              const std::string& commit2) {
     if (commit1.empty() || commit2.empty()) return "";
 
     std::set<std::string> history1;
-    std::string current = commit1;
-    while (!current.empty()) {
-        if (history1.count(current)) break;
-        history1.insert(current);
-        current = getParentCommit(current);
+    std::vector<std::string> queue{commit1};
+    while (!queue.empty()) {
+        std::string current = queue.back();
+        queue.pop_back();
+        if (!history1.insert(current).second) continue;
+        for (const auto& parent : parentsOf(current)) queue.push_back(parent);
     }
 
-    current = commit2;
-    while (!current.empty()) {
-        if (history1.count(current)) return current;
-        current = getParentCommit(current);
-        if (current == commit2) break;
+    // Breadth-first from commit2 so the closest shared commit wins
+    std::set<std::string> seen{commit2};
+    std::vector<std::string> level{commit2};
+    while (!level.empty()) {
+        std::vector<std::string> next;
+        for (const auto& current : level) {
+            if (history1.count(current)) return current;
+            for (const auto& parent : parentsOf(current)) {
+                if (seen.insert(parent).second) next.push_back(parent);
+            }
+        }
+        level.swap(next);
     }
 
     return "";
 }
 
-std::unordered_map<std::string, std::string> 
-    MergeManager::getCommitFiles(const std::string& commitHash) {
-    std::unordered_map<std::string, std::string> files;
-    if (commitHash.empty()) return files;
-
-    std::string content = Utils::readBlobContent(commitHash);
-    std::istringstream iss(content);
-    std::string line;
-    
-    while (std::getline(iss, line)) {
-        if (line.rfind("file ", 0) == 0) {
-            size_t space1 = line.find(' ', 5);
-            if (space1 != std::string::npos) {
-                std::string filename = line.substr(5, space1 - 5);
-                std::string hash = line.substr(space1 + 1);
-                files[filename] = hash;
-            }
-        }
-    }
-    return files;
+bool MergeManager::isAncestor(const std::string& ancestor, const std::string& descendant) {
+    return !ancestor.empty() && findCommonAncestor(descendant, ancestor) == ancestor;
 }
 
-std::string MergeManager::getParentCommit(const std::string& commitHash) {
-    if (commitHash.empty()) return "";
+// Full file list of a commit, from its manifest or (for commits written
+// before manifests existed) its inline "file" lines. False if the commit or
+// part of its manifest cannot be read; callers that delete or rewrite files
+// from the list must stop then.
+bool MergeManager::getCommitFiles(const std::string& commitHash,
+                                  std::unordered_map<std::string, std::string>& files) {
+    if (commitHash.empty()) return true;
+
+    CommitInfo commit;
+    if (!Utils::readCommit(commitHash, commit)) return false;
+    if (!commit.manifest.empty()) return Manifest::read(commit.manifest, files);
+    for (auto& [path, hash] : commit.files) files[path] = std::move(hash);
+    return true;
+}
 
-    std::string content = Utils::readBlobContent(commitHash);
-    std::istringstream iss(content);
-    std::string line;
-    
-    while (std::getline(iss, line)) {
-        if (line.rfind("parent ", 0) == 0) {
-            return line.substr(7);
-        }
+// Blob of one path in a commit ("" if absent), without reading the rest
+// of its manifest
+std::string MergeManager::getCommitFile(const std::string& commitHash, const std::string& path) {
+    CommitInfo commit;
+    if (commitHash.empty() || !Utils::readCommit(commitHash, commit)) return "";
+    if (!commit.manifest.empty()) return Manifest::lookup(commit.manifest, path);
+    for (const auto& [file, hash] : commit.files) {
+        if (file == path) return hash;
     }
     return "";
 }
 
+// Best-effort variant for display: whatever could be read
+std::unordered_map<std::string, std::string> 
+    MergeManager::getCommitFiles(const std::string& commitHash) {
+    std::unordered_map<std::string, std::string> files;
+    getCommitFiles(commitHash, files);
+    return files;
+}
+
 namespace {
     void writeConflictFile(const std::string& filename,
-                           const std::string& ourContent,
-                           const std::string& theirContent,
+                           std::string_view ourContent,
+                           std::string_view theirContent,
                            const std::string& branchName) {
         std::ostringstream conflictContent;
         conflictContent << "<<<<<<< HEAD\n" << ourContent
@@ -101,13 +122,11 @@ bool MergeManager::mergeBranch(const std::string& branchName) {
         return false;
     }
 
-    std::string currentCommit = Utils::readFile(
-        Constants::GIT_DIR + "/refs/heads/" + currentBranch);
-    std::string otherCommit = Utils::readFile(
-        Constants::GIT_DIR + "/refs/heads/" + branchName);
+    std::string currentCommit = RefStore::readRef("refs/heads/" + currentBranch);
+    std::string otherCommit = RefStore::readRef("refs/heads/" + branchName);
 
     if (currentCommit.empty()) {
-        if (!Utils::writeFile(Constants::GIT_DIR + "/refs/heads/" + currentBranch, otherCommit)) {
+        if (!RefStore::writeRef("refs/heads/" + currentBranch, otherCommit)) {
             std::cerr << "Error: Failed to update branch reference\n";
             return false;
         }
@@ -115,19 +134,63 @@ bool MergeManager::mergeBranch(const std::string& branchName) {
         return true;
     }
 
+    // The merge commit is built from the two manifests and then owns the
+    // staging area, so earlier staged changes would be silently dropped
+    if (!FileAdder::getStagedEntries().empty()) {
+        std::cerr << "Error: Changes are staged; commit them before merging\n";
+        return false;
+    }
+
     std::string lca = findCommonAncestor(currentCommit, otherCommit);
     if (lca.empty()) {
         std::cerr << "Error: No common ancestor found\n";
         return false;
     }
 
-    auto baseFiles = getCommitFiles(lca);
-    auto currentFiles = getCommitFiles(currentCommit);
-    auto otherFiles = getCommitFiles(otherCommit);
+    std::unordered_map<std::string, std::string> baseFiles, currentFiles, otherFiles;
+    if (!getCommitFiles(lca, baseFiles) || !getCommitFiles(currentCommit, currentFiles) ||
+        !getCommitFiles(otherCommit, otherFiles)) {
+        std::cerr << "Error: Could not read the manifests to merge\n";
+        return false;
+    }
 
     bool hasConflicts = false;
     std::set<std::string> allFiles;
     std::vector<std::string> modifiedFiles;
+    std::unordered_map<std::string, std::string> takenFromOther;
+
+    // Line up renames: when one side renamed a file that the other side
+    // still has under the old name, the old entries move to the new name so
+    // an edit on one side and a rename on the other merge cleanly
+    for (const auto& rename : RenameDetector::detect(baseFiles, otherFiles)) {
+        auto current = currentFiles.find(rename.from);
+        if (current == currentFiles.end() || currentFiles.count(rename.to)) continue;
+        baseFiles[rename.to] = baseFiles[rename.from];
+        baseFiles.erase(rename.from);
+        currentFiles[rename.to] = current->second;
+        currentFiles.erase(current);
+
+        if (SparseCheckout::contains(rename.from) && SparseCheckout::contains(rename.to)) {
+            std::error_code ec;
+            std::filesystem::path target(rename.to);
+            if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path(), ec);
+            std::filesystem::rename(rename.from, target, ec);
+            if (!ec) {
+                modifiedFiles.push_back(rename.to);
+                modifiedFiles.push_back(rename.from);  // stages the removal
+            }
+        }
+        std::cout << "Renamed in " << branchName << ": " << rename.from << " -> " << rename.to
+                  << " (" << rename.similarity << "%)\n";
+    }
+    for (const auto& rename : RenameDetector::detect(baseFiles, currentFiles)) {
+        auto other = otherFiles.find(rename.from);
+        if (other == otherFiles.end() || otherFiles.count(rename.to)) continue;
+        baseFiles[rename.to] = baseFiles[rename.from];
+        baseFiles.erase(rename.from);
+        otherFiles[rename.to] = other->second;
+        otherFiles.erase(other);
+    }
 
     for (const auto& pair : baseFiles) allFiles.insert(pair.first);
     for (const auto& pair : currentFiles) allFiles.insert(pair.first);
@@ -137,27 +200,29 @@ bool MergeManager::mergeBranch(const std::string& branchName) {
         std::string baseHash = baseFiles.count(file) ? baseFiles[file] : "";
         std::string currentHash = currentFiles.count(file) ? currentFiles[file] : "";
         std::string otherHash = otherFiles.count(file) ? otherFiles[file] : "";
+        bool inCone = SparseCheckout::contains(file);
 
         //  Case 0: File exists only in other branch (new file)
-        if (baseHash.empty() && currentHash.empty() && !otherHash.empty()) {
-            std::string content = Utils::readBlobContent(otherHash);
-            if (!content.empty()) {
-                Utils::writeFile(file, content);
-                if (FileAdder::addFile(file)) {
-                    modifiedFiles.push_back(file);
-                }
+        //  Case 1: Unchanged in current, changed in other → take from other
+        if ((baseHash.empty() && currentHash.empty() && !otherHash.empty()) ||
+            (baseHash == currentHash && baseHash != otherHash)) {
+            takenFromOther[file] = otherHash;  // empty: deleted on the other side
+            if (otherHash.empty()) {
+                std::error_code ec;
+                if (inCone && std::filesystem::remove(file, ec)) modifiedFiles.push_back(file);
+                continue;
             }
-            continue;
-        }
 
-        // Case 1: Unchanged in current, changed in other → take from other
-        if (baseHash == currentHash && baseHash != otherHash) {
-            std::string content = Utils::readBlobContent(otherHash);
-            if (!content.empty()) {
-                Utils::writeFile(file, content);
-                if (FileAdder::addFile(file)) {
-                    modifiedFiles.push_back(file);
-                }
+            // Outside the sparse cones only the merge commit records the file
+            if (!inCone) continue;
+
+            ObjectView content = Utils::readObject(otherHash);
+            if (ChunkStore::isChunkList(content.view())) {
+                ChunkStore::writeFile(file, content.view());
+                modifiedFiles.push_back(file);
+            } else if (!content.empty()) {
+                Utils::writeFile(file, content.view());
+                modifiedFiles.push_back(file);
             }
             continue;
         }
@@ -169,13 +234,30 @@ bool MergeManager::mergeBranch(const std::string& branchName) {
 
         // Case 3: Changed in both → conflict
         if (currentHash != otherHash) {
-            std::string currentContent = Utils::readBlobContent(currentHash);
-            std::string otherContent = Utils::readBlobContent(otherHash);
+            ObjectView currentObject = Utils::readObject(currentHash);
+            ObjectView otherObject = Utils::readObject(otherHash);
+
+            // Chunked blobs are reassembled; plain ones are used in place
+            std::string currentChunked, otherChunked;
+            std::string_view currentContent = currentObject.view();
+            std::string_view otherContent = otherObject.view();
+            if ((ChunkStore::isChunkList(currentContent) &&
+                 !ChunkStore::readContent(currentContent, currentChunked)) ||
+                (ChunkStore::isChunkList(otherContent) && !ChunkStore::readContent(otherContent, otherChunked))) {
+                std::cerr << "Error: Missing or damaged chunk in " << file << "\n";
+                return false;
+            }
+            if (ChunkStore::isChunkList(currentContent)) currentContent = currentChunked;
+            if (ChunkStore::isChunkList(otherContent)) otherContent = otherChunked;
 
             if (currentContent != otherContent) {
+                hasConflicts = true;
+                if (!inCone) {
+                    std::cerr << "CONFLICT (outside sparse checkout): " << file << "\n";
+                    continue;
+                }
                 writeConflictFile(file, currentContent, otherContent, branchName);
                 modifiedFiles.push_back(file);
-                hasConflicts = true;
                 std::cerr << "CONFLICT (content): " << file << "\n";
             }
         }
@@ -199,13 +281,32 @@ bool MergeManager::mergeBranch(const std::string& branchName) {
                   << "parent " << otherCommit << "\n"
                   << "branch " << currentBranch << "\n";
 
-    auto finalFiles = getCommitFiles(currentCommit);
-    auto otherFilesTemp = getCommitFiles(otherCommit);
-    finalFiles.insert(otherFilesTemp.begin(), otherFilesTemp.end());
-
+    // The merge result is the current manifest with the other side's
+    // changes (and the rename moves) applied copy-on-write
+    std::unordered_map<std::string, std::string> originalFiles;
+    if (!getCommitFiles(currentCommit, originalFiles)) {
+        std::cerr << "Error: Could not read the manifests to merge\n";
+        return false;
+    }
+    auto finalFiles = currentFiles;
+    for (const auto& [file, hash] : takenFromOther) {
+        if (hash.empty()) finalFiles.erase(file);
+        else finalFiles[file] = hash;
+    }
+    std::unordered_map<std::string, std::string> changes;
     for (const auto& [file, hash] : finalFiles) {
-        commitContent << "file " << file << " " << hash << "\n";
+        auto it = originalFiles.find(file);
+        if (it == originalFiles.end() || it->second != hash) changes[file] = hash;
+    }
+    for (const auto& entry : originalFiles) {
+        if (!finalFiles.count(entry.first)) changes[entry.first] = "";
+    }
+    std::string root = Manifest::updateCommit(currentCommit, changes);
+    if (root.empty()) {
+        std::cerr << "Error: Failed to build merge manifest\n";
+        return false;
     }
+    commitContent << "manifest " << root << "\n";
 
     std::string commitHash = Utils::computeSHA1(commitContent.str());
     if (!Utils::writeObject(commitHash, commitContent.str())) {
@@ -213,11 +314,18 @@ bool MergeManager::mergeBranch(const std::string& branchName) {
         return false;
     }
 
-    if (!Utils::writeFile(Constants::GIT_DIR + "/refs/heads/" + currentBranch, commitHash)) {
+    if (!RefStore::writeRef("refs/heads/" + currentBranch, commitHash)) {
         std::cerr << "Error: Failed to update branch reference\n";
         return false;
     }
 
+    CommitGraph::lookup(commitHash);
+    CommitGraph::save();
+
+    // Staging was empty before the merge, so everything in it was staged
+    // above and is now part of the merge commit
+    std::ofstream(Constants::STAGING_FILE, std::ios::trunc).close();
+
     std::cout << "Merge made by three-way strategy\n";
     return true;
 }
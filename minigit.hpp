@@ -3,9 +3,17 @@
 #define MINIGIT_HPP
 
 #include <string>
+#include <iosfwd>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
 #include <filesystem>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
 #include <ctime>
 
 namespace MiniGit {
@@ -15,10 +23,27 @@ namespace Constants {
     const std::string GIT_DIR = ".minigit";
     const std::string STAGING_FILE = ".minigit/staging";
     const std::string HEAD_FILE = ".minigit/HEAD";
-    const std::string BRANCHES_FILE = ".minigit/branches";  
+    const std::string BRANCHES_FILE = ".minigit/branches";  // legacy list, superseded by RefStore
+    const std::string PACKED_REFS_FILE = ".minigit/packed-refs";
     const std::string OBJECTS_DIR = ".minigit/objects";
+    const std::string SPARSE_FILE = ".minigit/sparse-checkout";
+    const std::string IGNORE_FILE = ".minigitignore";
+    const std::string COMMIT_GRAPH_FILE = ".minigit/commit-graph";
+    const std::string REMOTES_DIR = ".minigit/remotes";
+    const std::string FSMONITOR_DIR = ".minigit/fsmonitor";
+    const std::string WORKTREE_FILE = ".minigit/worktree";
 }
 
+// Parsed form of a commit object
+struct CommitInfo {
+    std::string message;
+    std::time_t time = 0;
+    std::vector<std::string> parents;
+    std::string branch;
+    std::string manifest;                                    // manifest root, if any
+    std::vector<std::pair<std::string, std::string>> files;  // path, blob hash (older commits)
+};
+
 // Class to initialize repository and check if initialized
 class Initializer {
 public:
@@ -30,7 +55,51 @@ public:
 class FileAdder {
 public:
     static bool addFile(const std::string& filename);
+    static bool addDirectory(const std::string& directory);
     static std::vector<std::string> getStagedFiles();
+    static std::unordered_map<std::string, std::string> getStagedEntries();
+    static std::vector<std::string> listFiles(const std::string& root);
+};
+
+// Class to match paths against .minigitignore rules (gitignore syntax without
+// negation). Rules are compiled once: literal paths into a directory trie,
+// literal names and "*.ext" suffixes into hash indexes, and only the
+// remaining wildcard rules into compiled globs.
+class IgnoreRules {
+public:
+    static bool isIgnored(const std::string& path, bool isDirectory);
+};
+
+// Class to watch the working tree with inotify from a background process
+// that journals changed paths to .minigit/fsmonitor. Tokens name a point in
+// the journal; changedSince() reports what happened after one.
+class FsMonitor {
+public:
+    static bool start();
+    static bool stop();
+    static bool isRunning();
+    static std::string currentToken();
+    static bool changedSince(const std::string& token, std::unordered_set<std::string>& paths,
+                             std::string& newToken);
+};
+
+// Class to cache the size, mtime and hash of every working-tree file in
+// .minigit/worktree, together with the fsmonitor token it is current as of.
+// Used by status, "add ." and checkout to find modified files without
+// re-hashing (or, with the monitor running, even stat'ing) the whole tree.
+class WorkingTree {
+public:
+    struct Entry {
+        uintmax_t size = 0;
+        long long mtime = 0;  // 0 when too recent to trust
+        std::string hash;
+    };
+
+    static const std::map<std::string, Entry>& refresh(const std::string& root = ".");
+    static void record(const std::string& path, const std::string& hash);
+    static bool save();
+    static void invalidate();
+    static bool showStatus();
 };
 
 // Class to handle committing staged changes with messages
@@ -40,10 +109,155 @@ public:
     static bool commit(const std::string& message, bool checkStaged = true);
 };
 
-// Class to display commit logs/history
+// Class to pair deleted paths with added ones between two manifests: first
+// by identical blob, then by content similarity (0-100) estimated from
+// MinHash sketches. With copies, unchanged paths may also be sources.
+class RenameDetector {
+public:
+    static constexpr int DEFAULT_MIN_SIMILARITY = 50;
+
+    struct Rename {
+        std::string from;
+        std::string to;
+        int similarity;
+        bool copy;
+    };
+
+    static std::vector<Rename> detect(const std::unordered_map<std::string, std::string>& before,
+                                      const std::unordered_map<std::string, std::string>& after,
+                                      bool copies = false,
+                                      int minSimilarity = DEFAULT_MIN_SIMILARITY);
+};
+
+// Class to store a commit's file list as a persistent hash trie of manifest
+// objects: leaves of up to 32 "file <path> <hash>" lines, inner nodes of up
+// to 32 children picked by 5 bits of the path's hash. Nodes are content-
+// addressed and never modified, so a commit that changes a few files writes
+// only the nodes on their paths and shares the rest with its parent.
+class Manifest {
+public:
+    static std::string write(const std::unordered_map<std::string, std::string>& files);
+    static std::string update(const std::string& root, const std::unordered_map<std::string, std::string>& changes);
+    static bool read(const std::string& root, std::unordered_map<std::string, std::string>& files);
+    static std::string lookup(const std::string& root, const std::string& path);
+    static bool diff(const std::string& before, const std::string& after,
+                     const std::function<void(const std::string&, const std::string&, const std::string&)>& visit);
+    static bool readNode(const std::string& hash, std::vector<std::string>& nodes,
+                         std::vector<std::pair<std::string, std::string>>& files);
+    static std::string updateCommit(const std::string& commitHash,
+                                    const std::unordered_map<std::string, std::string>& changes);
+};
+
+// Class to display commit logs/history from HEAD, the given revisions or
+// (with all) every ref, following all parents in date or topological
+// order. With a path, only commits that changed it (or anything below it)
+// are shown; follow continues past renames of a single file. maxCount < 0
+// means no limit; since = 0 means no cutoff. format uses %H %h %P %p %s %d
+// %ad %as %ai %at %n placeholders; empty selects the default layout.
 class Logger {
 public:
-    static void showLog();
+    enum class Order { Date, Topo };
+
+    struct Options {
+        std::vector<std::string> revisions;
+        bool all = false;
+        std::string path;
+        long maxCount = -1;
+        std::time_t since = 0;
+        std::string format;
+        bool follow = false;
+        Order order = Order::Date;
+    };
+
+    static bool showLog(const Options& options);
+    static bool parseDate(const std::string& text, std::time_t& result);
+};
+
+// Class to list the paths that differ between two commits (added, deleted,
+// modified, and renamed or copied with their similarity)
+class Differ {
+public:
+    static bool showNameStatus(const std::string& from, const std::string& to, bool copies = false);
+};
+
+// Class to search the files of a commit for a regular expression without
+// touching the working tree
+class Grepper {
+public:
+    static bool grep(const std::string& pattern, const std::string& revision = "", bool ignoreCase = false);
+};
+
+// Class to export a commit's files as a tar stream (optionally gzipped)
+// straight from the object store
+class Archiver {
+public:
+    static bool writeArchive(const std::string& revision, const std::string& outputPath, bool gzip);
+};
+
+// Class to attribute each line of a file at HEAD to the commit that last
+// changed it
+class Blamer {
+public:
+    static bool blameFile(const std::string& path);
+};
+
+// Class to sync with another repository given by filesystem path (or by a
+// remote name recorded at clone time). The sender walks from the wanted
+// tips, stops at commits the receiver already has, and streams only the
+// missing objects as a single pack.
+class RemoteManager {
+public:
+    static bool clone(const std::string& source, const std::string& directory);
+    static bool fetch(const std::string& remoteName);
+    static bool push(const std::string& remoteName, const std::string& branchName);
+};
+
+// Class to import history from a git fast-import style stream (blob,
+// commit, reset, marks; M/D/C/R/deleteall file commands). Each imported
+// commit records its full file list.
+class FastImporter {
+public:
+    static bool run(std::istream& in);
+};
+
+// Class to delete unreachable loose objects. Marking walks the commit DAG
+// from every ref, HEAD and the staging area on the worker pool; sweeping
+// only removes unmarked objects older than the grace period.
+class Pruner {
+public:
+    static constexpr long DEFAULT_EXPIRE_SECONDS = 14 * 24 * 60 * 60;
+
+    static std::unordered_set<std::string> reachableObjects(
+        const std::vector<std::string>& tips,
+        const std::function<bool(const std::string&)>& skipCommit = {});
+    static bool prune(long expireSeconds, bool dryRun);
+};
+
+// Class to verify the object store: every object must hash to its name and
+// every reachable commit's parents and file blobs must exist
+class IntegrityChecker {
+public:
+    static bool fsck();
+};
+
+// Class to cache per-commit graph data in .minigit/commit-graph: parents,
+// time, generation number and a Bloom filter of the paths the commit changed
+// relative to its first parent. Entries are computed on first lookup and
+// persisted by save(), so history walks need not open commit objects.
+class CommitGraph {
+public:
+    struct Entry {
+        std::vector<std::string> parents;
+        std::time_t time = 0;
+        uint32_t generation = 0;
+        bool allChanged = false;            // too many paths for a filter
+        std::vector<uint64_t> bloom;
+    };
+
+    static const Entry* lookup(const std::string& commitHash);
+    static bool mayChangePath(const Entry& entry, const std::string& path);
+    static std::vector<std::string> changedPaths(const std::string& commitHash);
+    static bool save();
 };
 
 // Class to manage branches: create, delete, list, checkout, check existence
@@ -57,32 +271,138 @@ public:
     static bool branchExists(const std::string& branchName);
 };
 
+// Class to resolve and update refs ("refs/heads/<branch>"). Loose ref files
+// override entries in the sorted packed-refs file, which is mapped once and
+// binary-searched in place; both are loaded into a single per-process table.
+class RefStore {
+public:
+    static std::string readRef(const std::string& name);
+    static bool writeRef(const std::string& name, const std::string& hash);
+    static bool deleteRef(const std::string& name);
+    static std::map<std::string, std::string> listRefs(const std::string& prefix);
+    static bool packRefs();
+    static void reload();
+    static std::string resolveHead();
+    static std::string resolve(const std::string& revision);
+};
+
 // Class to checkout commits or branches
 class CheckoutManager {
 public:
     static bool checkoutCommit(const std::string& commitHash, const std::string& branchName);
 };
 
+// Class to restrict the working tree to a set of directory cones. Top-level
+// files, files directly inside a cone's ancestors, and everything below a
+// cone are included; all other paths are left out of checkout, add and merge.
+class SparseCheckout {
+public:
+    static bool isEnabled();
+    static bool contains(const std::string& path);
+    static bool containsDirectory(const std::string& directory);
+    static std::vector<std::string> getPatterns();
+    static bool setPatterns(const std::vector<std::string>& patterns);
+    static bool disable();
+};
+
 // Class to manage merging branches with a three-way merge strategy
 class MergeManager {
 public:
     static bool mergeBranch(const std::string& branchName);
     static std::unordered_map<std::string, std::string> getCommitFiles(const std::string& commitHash);
-private:
+    static bool getCommitFiles(const std::string& commitHash, std::unordered_map<std::string, std::string>& files);
+    static std::string getCommitFile(const std::string& commitHash, const std::string& path);
     static std::string findCommonAncestor(const std::string& commit1, const std::string& commit2);
-    static std::string getParentCommit(const std::string& commitHash);
+    static bool isAncestor(const std::string& ancestor, const std::string& descendant);
 };
 
 
+// Read-only view of a file or object. Files at or above MMAP_THRESHOLD are
+// memory-mapped; smaller ones are read into a pooled buffer. Either way the
+// caller borrows the bytes instead of copying them into a fresh string.
+class ObjectView {
+public:
+    static constexpr size_t MMAP_THRESHOLD = 64 * 1024;
+
+    ObjectView() = default;
+    ~ObjectView();
+    ObjectView(ObjectView&& other) noexcept;
+    ObjectView& operator=(ObjectView&& other) noexcept;
+    ObjectView(const ObjectView&) = delete;
+    ObjectView& operator=(const ObjectView&) = delete;
+
+    static ObjectView open(const std::string& path);
+
+    bool valid() const { return isOpen; }
+    bool empty() const { return length == 0; }
+    const char* data() const { return ptr; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(ptr, length); }
+    std::string str() const { return std::string(ptr, length); }
+
+private:
+    void release();
+
+    const char* ptr = nullptr;
+    size_t length = 0;
+    void* mapping = nullptr;
+    std::string buffer;
+    bool isOpen = false;
+};
+
+// Class to store large files as content-defined chunks, so a small edit to a
+// big file only adds the few chunks around it. A chunked blob is still named
+// by the SHA-1 of the whole file, but its object holds a chunk list instead
+// of the bytes; FastCDC gear-hash boundaries keep unchanged regions aligned.
+class ChunkStore {
+public:
+    static constexpr size_t CHUNK_THRESHOLD = 1024 * 1024;
+
+    struct Chunk {
+        std::string hash;
+        size_t size;
+    };
+
+    static bool writeBlob(const std::string& hash, std::string_view content);
+    static bool isChunkList(std::string_view object);
+    static bool isChunked(const std::string& hash);
+    static std::vector<Chunk> chunksOf(std::string_view object);
+    static bool writeFile(const std::string& path, std::string_view object);
+    static bool readContent(std::string_view object, std::string& content);
+    static std::string contentHash(std::string_view object);
+};
+
+// Caps how many bytes concurrent workers may hold at once. A request larger
+// than the whole budget is admitted only when nothing else is in flight.
+class ByteBudget {
+public:
+    explicit ByteBudget(size_t limit) : limit(limit) {}
+    void acquire(size_t bytes);
+    void release(size_t bytes);
+
+private:
+    std::mutex mutex;
+    std::condition_variable available;
+    size_t limit;
+    size_t inFlight = 0;
+};
+
 // Utility functions used by MiniGit system
 namespace Utils {
-    std::string computeSHA1(const std::string& content);
+    std::string computeSHA1(std::string_view content);
+    uint64_t fnv1a(std::string_view text);
+    uint64_t mix(uint64_t x);
     std::string generateHash();
     std::string readFile(const std::string& path);
-    bool writeFile(const std::string& path, const std::string& content);
+    bool writeFile(const std::string& path, std::string_view content);
     bool makeDirectory(const std::string& path);
-    bool writeObject(const std::string& hash, const std::string& content);
+    bool writeObject(const std::string& hash, std::string_view content);
+    std::string objectPath(const std::string& hash);
+    ObjectView readObject(const std::string& hash);
+    bool readCommit(const std::string& hash, CommitInfo& commit);
     std::string readBlobContent(const std::string& hash);
+    unsigned workerCount();
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
 }
 
 } // namespace MiniGit
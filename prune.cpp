@@ -0,0 +1,185 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+namespace MiniGit {
+
+namespace {
+    const size_t MARK_SHARDS = 64;
+
+    // Mark bits sharded by hash prefix so workers rarely contend
+    struct MarkSet {
+        std::mutex locks[MARK_SHARDS];
+        std::unordered_set<std::string> shards[MARK_SHARDS];
+
+        // True if the hash was not marked before
+        bool mark(const std::string& hash) {
+            size_t shard = std::hash<std::string>()(hash) % MARK_SHARDS;
+            std::lock_guard<std::mutex> lock(locks[shard]);
+            return shards[shard].insert(hash).second;
+        }
+    };
+
+    // A chunked blob keeps its chunks alive
+    void markChunks(MarkSet& marks, const std::string& blobHash) {
+        if (!ChunkStore::isChunked(blobHash)) return;
+        ObjectView list = Utils::readObject(blobHash);
+        for (const auto& chunk : ChunkStore::chunksOf(list.view())) marks.mark(chunk.hash);
+    }
+
+    // Manifest nodes and their blobs; a node already marked was reached
+    // through an earlier commit that shares it, so its subtree is skipped
+    void markManifest(MarkSet& marks, const std::string& root) {
+        std::vector<std::string> stack;
+        if (marks.mark(root)) stack.push_back(root);
+        std::vector<std::string> nodes;
+        std::vector<std::pair<std::string, std::string>> files;
+        while (!stack.empty()) {
+            std::string node = std::move(stack.back());
+            stack.pop_back();
+            nodes.clear();
+            files.clear();
+            if (!Manifest::readNode(node, nodes, files)) continue;
+            for (auto& child : nodes) {
+                if (marks.mark(child)) stack.push_back(std::move(child));
+            }
+            for (const auto& file : files) {
+                if (marks.mark(file.second)) markChunks(marks, file.second);
+            }
+        }
+    }
+}
+
+// Every object reachable from the given commits: the commits themselves,
+// their ancestors, their manifest nodes and all blobs (and blob chunks)
+// those name. Workers share one
+// stack of commits still to visit; each commit is read exactly once.
+// Commits for which skipCommit returns true (e.g. ones a peer already has)
+// are neither included nor walked past.
+std::unordered_set<std::string> Pruner::reachableObjects(
+    const std::vector<std::string>& tips,
+    const std::function<bool(const std::string&)>& skipCommit) {
+    MarkSet marks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::string> pending;
+    size_t busy = 0;
+
+    auto wanted = [&](const std::string& hash) {
+        return hash.length() == 40 && !(skipCommit && skipCommit(hash)) && marks.mark(hash);
+    };
+    for (const auto& tip : tips) {
+        if (wanted(tip)) pending.push_back(tip);
+    }
+
+    auto worker = [&] {
+        std::vector<std::string> discovered;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&] { return !pending.empty() || busy == 0; });
+            if (pending.empty()) break;
+
+            std::string commitHash = std::move(pending.back());
+            pending.pop_back();
+            ++busy;
+            lock.unlock();
+
+            CommitInfo commit;
+            if (Utils::readCommit(commitHash, commit)) {
+                if (!commit.manifest.empty()) markManifest(marks, commit.manifest);
+                for (const auto& file : commit.files) {
+                    if (marks.mark(file.second)) markChunks(marks, file.second);
+                }
+                for (const auto& parent : commit.parents) {
+                    if (wanted(parent)) discovered.push_back(parent);
+                }
+            }
+
+            lock.lock();
+            --busy;
+            for (auto& parent : discovered) pending.push_back(std::move(parent));
+            discovered.clear();
+            wake.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < Utils::workerCount(); ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+
+    std::unordered_set<std::string> reachable;
+    for (auto& shard : marks.shards) {
+        reachable.merge(shard);
+    }
+    return reachable;
+}
+
+// Delete loose objects that nothing references and that are older than the
+// grace period (which protects objects written by commands still running)
+bool Pruner::prune(long expireSeconds, bool dryRun) {
+    namespace fs = std::filesystem;
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+
+    // Roots: every ref, HEAD (possibly detached) and the staged blobs
+    std::vector<std::string> tips;
+    for (const auto& ref : RefStore::listRefs("")) tips.push_back(ref.second);
+    tips.push_back(RefStore::resolveHead());
+    std::unordered_set<std::string> reachable = reachableObjects(tips);
+    for (const auto& staged : FileAdder::getStagedEntries()) {
+        if (staged.second.empty()) continue;  // a staged removal
+        if (!reachable.insert(staged.second).second || !ChunkStore::isChunked(staged.second)) continue;
+        ObjectView list = Utils::readObject(staged.second);
+        for (const auto& chunk : ChunkStore::chunksOf(list.view())) reachable.insert(chunk.hash);
+    }
+
+    // Sweep the 256 fan-out directories in parallel
+    std::vector<fs::path> fanout;
+    std::error_code ec;
+    for (fs::directory_iterator it(Constants::OBJECTS_DIR, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_directory() && it->path().filename().string().size() == 2) {
+            fanout.push_back(it->path());
+        }
+    }
+
+    auto cutoff = fs::file_time_type::clock::now() - std::chrono::seconds(expireSeconds);
+    std::atomic<size_t> pruned{0}, prunedBytes{0}, kept{0};
+    std::mutex reportMutex;
+
+    Utils::parallelFor(fanout.size(), [&](size_t i) {
+        std::string prefix = fanout[i].filename().string();
+        std::error_code dirError;
+        for (fs::directory_iterator it(fanout[i], dirError), end; !dirError && it != end; it.increment(dirError)) {
+            std::string hash = prefix + it->path().filename().string();
+            std::error_code fileError;
+            if (reachable.count(hash) || it->last_write_time(fileError) > cutoff || fileError) {
+                ++kept;
+                continue;
+            }
+
+            uintmax_t size = it->file_size(fileError);
+            if (dryRun) {
+                std::lock_guard<std::mutex> lock(reportMutex);
+                std::cout << "Would prune " << hash << "\n";
+            } else if (!fs::remove(it->path(), fileError)) {
+                continue;
+            }
+            ++pruned;
+            prunedBytes += fileError ? 0 : static_cast<size_t>(size);
+        }
+        if (!dryRun && fs::is_empty(fanout[i], dirError)) {
+            fs::remove(fanout[i], dirError);
+        }
+    });
+
+    std::cout << (dryRun ? "Would prune " : "Pruned ") << pruned << " object(s), "
+              << (prunedBytes / 1024) << " KiB; " << kept << " kept\n";
+    return true;
+}
+
+} // namespace MiniGit
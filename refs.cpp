@@ -0,0 +1,237 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <map>
+
+namespace MiniGit {
+
+namespace {
+    const std::string PACKED_HEADER = "# pack-refs sorted\n";
+
+    // The process-wide ref table: the mapped packed-refs file, searched in
+    // place, plus every loose ref (which overrides a packed entry of the
+    // same name). Loaded on first use and kept in sync by every update.
+    struct RefTable {
+        ObjectView packed;
+        std::map<std::string, std::string> loose;
+        bool loaded = false;
+    };
+
+    RefTable& refTable() {
+        static RefTable table;
+        return table;
+    }
+
+    void scanLooseRefs(std::map<std::string, std::string>& loose) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        fs::path base(Constants::GIT_DIR);
+        for (fs::recursive_directory_iterator it(base / "refs", ec), end; !ec && it != end; it.increment(ec)) {
+            if (!it->is_regular_file()) continue;
+            std::string hash = Utils::readFile(it->path().string());
+            while (!hash.empty() && (hash.back() == '\n' || hash.back() == '\r')) hash.pop_back();
+            if (!hash.empty()) {
+                loose[fs::relative(it->path(), base).generic_string()] = hash;
+            }
+        }
+    }
+
+    RefTable& loadedTable() {
+        RefTable& table = refTable();
+        if (!table.loaded) {
+            table.packed = ObjectView::open(Constants::PACKED_REFS_FILE);
+            table.loose.clear();
+            scanLooseRefs(table.loose);
+            table.loaded = true;
+        }
+        return table;
+    }
+
+    // A packed-refs line is "<40-hex hash> <refname>"
+    std::string_view lineAt(std::string_view data, size_t pos, size_t& next) {
+        size_t eol = data.find('\n', pos);
+        next = eol == std::string_view::npos ? data.size() : eol + 1;
+        return data.substr(pos, (eol == std::string_view::npos ? data.size() : eol) - pos);
+    }
+
+    std::string_view refNameOf(std::string_view line) {
+        return line.size() > 41 ? line.substr(41) : std::string_view();
+    }
+
+    // Byte offset of the first packed line whose name is >= key. Bisects
+    // over byte offsets, realigning each probe to the start of its line.
+    size_t packedLowerBound(std::string_view data, std::string_view key) {
+        size_t begin = data.rfind(PACKED_HEADER, 0) == 0 ? PACKED_HEADER.size() : 0;
+        size_t lo = begin, hi = data.size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            size_t lineStart = mid;
+            while (lineStart > lo && data[lineStart - 1] != '\n') --lineStart;
+
+            size_t next;
+            std::string_view line = lineAt(data, lineStart, next);
+            if (refNameOf(line) < key) {
+                lo = next;
+            } else {
+                hi = lineStart;
+            }
+        }
+        return lo;
+    }
+
+    std::string packedLookup(const RefTable& table, const std::string& name) {
+        std::string_view data = table.packed.view();
+        size_t next;
+        std::string_view line = lineAt(data, packedLowerBound(data, name), next);
+        if (refNameOf(line) == name) return std::string(line.substr(0, 40));
+        return "";
+    }
+
+    // All packed refs whose name starts with prefix, in sorted order
+    void packedRange(const RefTable& table, const std::string& prefix,
+                     std::map<std::string, std::string>& out) {
+        std::string_view data = table.packed.view();
+        size_t pos = packedLowerBound(data, prefix);
+        while (pos < data.size()) {
+            size_t next;
+            std::string_view line = lineAt(data, pos, next);
+            std::string_view name = refNameOf(line);
+            if (name.substr(0, prefix.size()) != prefix) break;
+            out.emplace(std::string(name), std::string(line.substr(0, 40)));
+            pos = next;
+        }
+    }
+
+    bool writePackedRefs(const std::map<std::string, std::string>& refs) {
+        std::string content = PACKED_HEADER;
+        for (const auto& [name, hash] : refs) {
+            content += hash + " " + name + "\n";
+        }
+
+        // Replace atomically so concurrent readers never see a partial file
+        std::string temp = Constants::PACKED_REFS_FILE + ".lock";
+        if (!Utils::writeFile(temp, content)) return false;
+        std::error_code ec;
+        std::filesystem::rename(temp, Constants::PACKED_REFS_FILE, ec);
+        return !ec;
+    }
+}
+
+// Resolve a full ref name (e.g. "refs/heads/main") to a commit hash
+std::string RefStore::readRef(const std::string& name) {
+    RefTable& table = loadedTable();
+    auto loose = table.loose.find(name);
+    if (loose != table.loose.end()) return loose->second;
+    return packedLookup(table, name);
+}
+
+bool RefStore::writeRef(const std::string& name, const std::string& hash) {
+    std::string path = Constants::GIT_DIR + "/" + name;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!Utils::makeDirectory(parent.string()) || !Utils::writeFile(path, hash)) {
+        return false;
+    }
+    loadedTable().loose[name] = hash;
+    return true;
+}
+
+bool RefStore::deleteRef(const std::string& name) {
+    RefTable& table = loadedTable();
+    bool found = false;
+
+    if (table.loose.erase(name)) {
+        std::error_code ec;
+        std::filesystem::remove(Constants::GIT_DIR + "/" + name, ec);
+        if (ec) return false;
+        found = true;
+    }
+
+    if (!packedLookup(table, name).empty()) {
+        std::map<std::string, std::string> packed;
+        packedRange(table, "", packed);
+        packed.erase(name);
+        table.packed = ObjectView();
+        if (!writePackedRefs(packed)) return false;
+        table.packed = ObjectView::open(Constants::PACKED_REFS_FILE);
+        found = true;
+    }
+    return found;
+}
+
+// Every ref under prefix (packed and loose, loose winning), sorted by name
+std::map<std::string, std::string> RefStore::listRefs(const std::string& prefix) {
+    RefTable& table = loadedTable();
+    std::map<std::string, std::string> refs;
+    packedRange(table, prefix, refs);
+    for (auto it = table.loose.lower_bound(prefix);
+         it != table.loose.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+        refs[it->first] = it->second;
+    }
+    return refs;
+}
+
+// Fold every loose ref into the sorted packed-refs file
+bool RefStore::packRefs() {
+    RefTable& table = loadedTable();
+    std::map<std::string, std::string> refs = listRefs("");
+    size_t looseCount = table.loose.size();
+
+    table.packed = ObjectView();
+    if (!writePackedRefs(refs)) {
+        std::cerr << "Error: Could not write " << Constants::PACKED_REFS_FILE << "\n";
+        reload();
+        return false;
+    }
+
+    // Drop the loose files and any namespace directories they leave empty
+    for (const auto& [name, hash] : table.loose) {
+        std::error_code ec;
+        std::filesystem::path path(Constants::GIT_DIR + "/" + name);
+        std::filesystem::remove(path, ec);
+        for (path = path.parent_path();
+             path.has_parent_path() && path.parent_path().filename() != "refs" &&
+             std::filesystem::is_empty(path, ec);
+             path = path.parent_path()) {
+            std::filesystem::remove(path, ec);
+        }
+    }
+
+    // The old append-only branch list is superseded by the ref table
+    std::error_code ec;
+    std::filesystem::remove(Constants::BRANCHES_FILE, ec);
+
+    reload();
+    std::cout << "Packed " << refs.size() << " ref(s) (" << looseCount << " loose)\n";
+    return true;
+}
+
+void RefStore::reload() {
+    RefTable& table = refTable();
+    table.packed = ObjectView();
+    table.loose.clear();
+    table.loaded = false;
+}
+
+// Commit hash HEAD points at, whether on a branch or detached
+std::string RefStore::resolveHead() {
+    std::string head = Utils::readFile(Constants::HEAD_FILE);
+    if (head.rfind("ref: ", 0) == 0) {
+        return readRef(head.substr(5));
+    }
+    return head;
+}
+
+// Resolve "HEAD", a branch name, a full ref name or a commit hash
+std::string RefStore::resolve(const std::string& revision) {
+    if (revision.empty() || revision == "HEAD") return resolveHead();
+
+    std::string hash = readRef("refs/heads/" + revision);
+    if (hash.empty() && revision.rfind("refs/", 0) == 0) hash = readRef(revision);
+    if (!hash.empty()) return hash;
+
+    if (revision.size() == 40 && std::filesystem::exists(Utils::objectPath(revision))) {
+        return revision;
+    }
+    return "";
+}
+
+} // namespace MiniGit
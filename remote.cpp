@@ -0,0 +1,291 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <fstream>
+
+namespace MiniGit {
+
+namespace fs = std::filesystem;
+
+namespace {
+    const std::string PACK_HEADER = "MINIGIT-PACK 1\n";
+    const std::string ORIGIN = "origin";
+
+    // Every path constant is relative to the repository root, so code runs
+    // against another repository by switching the working directory for
+    // the scope. The ref table is reloaded on entry and on exit.
+    class RepositoryScope {
+    public:
+        explicit RepositoryScope(const fs::path& root) : previous(fs::current_path()) {
+            fs::current_path(root);
+            RefStore::reload();
+        }
+        ~RepositoryScope() {
+            std::error_code ec;
+            fs::current_path(previous, ec);
+            RefStore::reload();
+        }
+        RepositoryScope(const RepositoryScope&) = delete;
+        RepositoryScope& operator=(const RepositoryScope&) = delete;
+
+    private:
+        fs::path previous;
+    };
+
+    bool hasObject(const fs::path& root, const std::string& hash) {
+        return fs::exists(root / Utils::objectPath(hash));
+    }
+
+    bool isRepository(const fs::path& root) {
+        return fs::exists(root / Constants::HEAD_FILE) && fs::exists(root / Constants::OBJECTS_DIR);
+    }
+
+    struct TransferStats {
+        size_t objects = 0;
+        size_t bytes = 0;
+    };
+
+    // Negotiate and write one pack: walk from the wanted tips in the source
+    // repository, stopping at any commit the destination already has, and
+    // stream every object the destination lacks into a single file
+    bool writePack(const fs::path& source, const fs::path& destination,
+                   const std::vector<std::string>& tips, const fs::path& packPath,
+                   TransferStats& stats) {
+        RepositoryScope scope(source);
+
+        auto haveCommit = [&](const std::string& hash) { return hasObject(destination, hash); };
+        std::unordered_set<std::string> missing = Pruner::reachableObjects(tips, haveCommit);
+
+        std::ofstream pack(packPath, std::ios::binary | std::ios::trunc);
+        if (!pack) return false;
+        pack << PACK_HEADER;
+
+        for (const auto& hash : missing) {
+            if (hasObject(destination, hash)) continue;  // blob shared with a known commit
+            ObjectView object = Utils::readObject(hash);
+            if (!object.valid()) {
+                std::cerr << "Error: Source object " << hash << " is missing\n";
+                return false;
+            }
+            pack << hash << " " << object.size() << "\n";
+            pack.write(object.data(), static_cast<std::streamsize>(object.size()));
+            ++stats.objects;
+            stats.bytes += object.size();
+        }
+        return static_cast<bool>(pack);
+    }
+
+    // Store every object of a pack into the current repository
+    bool unpack(const fs::path& packPath) {
+        ObjectView pack = ObjectView::open(packPath.string());
+        std::string_view data = pack.view();
+        if (data.rfind(PACK_HEADER, 0) != 0) {
+            std::cerr << "Error: Corrupt pack\n";
+            return false;
+        }
+        data.remove_prefix(PACK_HEADER.size());
+
+        while (!data.empty()) {
+            size_t eol = data.find('\n');
+            if (eol == std::string_view::npos || eol < 42) {
+                std::cerr << "Error: Corrupt pack entry\n";
+                return false;
+            }
+            std::string hash(data.substr(0, 40));
+            size_t size = std::stoull(std::string(data.substr(41, eol - 41)));
+            if (eol + 1 + size > data.size()) {
+                std::cerr << "Error: Truncated pack\n";
+                return false;
+            }
+            std::string_view content = data.substr(eol + 1, size);
+            data.remove_prefix(eol + 1 + size);
+
+            if (fs::exists(Utils::objectPath(hash))) continue;
+            if (!Utils::writeObject(hash, content)) {
+                std::cerr << "Error: Failed to store object " << hash << "\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Move the objects behind tips from one repository into another
+    bool transfer(const fs::path& source, const fs::path& destination,
+                  const std::vector<std::string>& tips, TransferStats& stats) {
+        fs::path packPath = destination / Constants::GIT_DIR /
+                            ("incoming-" + Utils::generateHash().substr(0, 12) + ".pack");
+        bool ok = writePack(source, destination, tips, packPath, stats);
+        if (ok) {
+            RepositoryScope scope(destination);
+            ok = unpack(packPath);
+        }
+        std::error_code ec;
+        fs::remove(packPath, ec);
+        return ok;
+    }
+
+    std::map<std::string, std::string> remoteBranches(const fs::path& remote) {
+        RepositoryScope scope(remote);
+        return RefStore::listRefs("refs/heads/");
+    }
+
+    // A remote name recorded at clone time ("origin" by default) or a plain
+    // path. Only named remotes get refs/remotes/<name>/ tracking refs.
+    bool resolveRemote(const std::string& nameOrPath, fs::path& remote, std::string& name) {
+        std::string spec = nameOrPath.empty() ? ORIGIN : nameOrPath;
+        std::string recorded = Utils::readFile(Constants::REMOTES_DIR + "/" + spec);
+        name = recorded.empty() ? "" : spec;
+        remote = fs::absolute(recorded.empty() ? spec : recorded).lexically_normal();
+        if (!isRepository(remote)) {
+            std::cerr << "Error: '" << spec << "' is not a MiniGit repository\n";
+            return false;
+        }
+        return true;
+    }
+
+    void printStats(const TransferStats& stats) {
+        std::cout << "Transferred " << stats.objects << " object(s), "
+                  << (stats.bytes + 1023) / 1024 << " KiB\n";
+    }
+}
+
+bool RemoteManager::clone(const std::string& source, const std::string& directory) {
+    fs::path remote = fs::absolute(source).lexically_normal();
+    if (!isRepository(remote)) {
+        std::cerr << "Error: '" << source << "' is not a MiniGit repository\n";
+        return false;
+    }
+    fs::path local = fs::absolute(directory).lexically_normal();
+    if (fs::exists(local) && !fs::is_empty(local)) {
+        std::cerr << "Error: Destination '" << directory << "' already exists and is not empty\n";
+        return false;
+    }
+
+    std::string remoteHead;
+    {
+        RepositoryScope scope(remote);
+        remoteHead = Utils::readFile(Constants::HEAD_FILE);
+    }
+    auto branches = remoteBranches(remote);
+
+    fs::create_directories(local / Constants::OBJECTS_DIR);
+    fs::create_directories(local / Constants::GIT_DIR / "refs" / "heads");
+    fs::create_directories(local / Constants::REMOTES_DIR);
+
+    std::vector<std::string> tips;
+    for (const auto& branch : branches) tips.push_back(branch.second);
+    TransferStats stats;
+    if (!transfer(remote, local, tips, stats)) return false;
+
+    RepositoryScope scope(local);
+    Utils::writeFile(Constants::STAGING_FILE, "");
+    Utils::writeFile(Constants::REMOTES_DIR + "/" + ORIGIN, remote.string());
+
+    const std::string prefix = "refs/heads/";
+    for (const auto& [ref, hash] : branches) {
+        std::string name = ref.substr(prefix.size());
+        RefStore::writeRef(ref, hash);
+        RefStore::writeRef("refs/remotes/" + ORIGIN + "/" + name, hash);
+    }
+
+    std::string branch = remoteHead.rfind("ref: " + prefix, 0) == 0
+        ? remoteHead.substr(5 + prefix.size()) : "main";
+    std::cout << "Cloned " << branches.size() << " branch(es) into " << directory << "\n";
+    printStats(stats);
+    if (!BranchManager::branchExists(branch)) {
+        Utils::writeFile(Constants::HEAD_FILE, "ref: " + prefix + branch);
+        return true;
+    }
+    return CheckoutManager::checkoutCommit(RefStore::readRef(prefix + branch), branch);
+}
+
+bool RemoteManager::fetch(const std::string& remoteName) {
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+    fs::path remote;
+    std::string name;
+    if (!resolveRemote(remoteName, remote, name)) return false;
+
+    auto branches = remoteBranches(remote);
+    std::vector<std::string> tips;
+    for (const auto& branch : branches) tips.push_back(branch.second);
+
+    TransferStats stats;
+    if (!transfer(remote, fs::current_path(), tips, stats)) return false;
+
+    const std::string prefix = "refs/heads/";
+    std::string tracking = "refs/remotes/" + name + "/";
+    for (const auto& [ref, hash] : branches) {
+        std::string branch = ref.substr(prefix.size());
+        if (name.empty()) {
+            std::cout << hash.substr(0, 7) << " " << branch << "\n";
+            continue;
+        }
+        std::string previous = RefStore::readRef(tracking + branch);
+        if (previous == hash) continue;
+        RefStore::writeRef(tracking + branch, hash);
+        std::cout << (previous.empty() ? "[new branch]" : previous.substr(0, 7) + ".." + hash.substr(0, 7))
+                  << " " << branch << " -> " << name << "/" << branch << "\n";
+    }
+    printStats(stats);
+    return true;
+}
+
+bool RemoteManager::push(const std::string& remoteName, const std::string& branchName) {
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+    fs::path remote;
+    std::string name;
+    if (!resolveRemote(remoteName, remote, name)) return false;
+
+    std::string branch = branchName.empty() ? BranchManager::getCurrentBranch() : branchName;
+    std::string ref = "refs/heads/" + branch;
+    std::string localTip = RefStore::readRef(ref);
+    if (localTip.empty()) {
+        std::cerr << "Error: Branch '" << branch << "' does not exist\n";
+        return false;
+    }
+
+    std::string remoteTip;
+    std::string remoteHead;
+    {
+        RepositoryScope scope(remote);
+        remoteTip = RefStore::readRef(ref);
+        remoteHead = Utils::readFile(Constants::HEAD_FILE);
+    }
+    if (remoteTip == localTip) {
+        std::cout << "Everything up-to-date\n";
+        return true;
+    }
+    if (!remoteTip.empty() && !MergeManager::isAncestor(remoteTip, localTip)) {
+        std::cerr << "Error: Push rejected (non-fast-forward); fetch and merge first\n";
+        return false;
+    }
+
+    TransferStats stats;
+    if (!transfer(fs::current_path(), remote, {localTip}, stats)) return false;
+
+    {
+        RepositoryScope scope(remote);
+        if (!RefStore::writeRef(ref, localTip)) {
+            std::cerr << "Error: Failed to update remote branch " << branch << "\n";
+            return false;
+        }
+    }
+    if (!name.empty()) {
+        RefStore::writeRef("refs/remotes/" + name + "/" + branch, localTip);
+    }
+
+    std::cout << (remoteTip.empty() ? "[new branch]" : remoteTip.substr(0, 7) + ".." + localTip.substr(0, 7))
+              << " " << branch << " -> " << branch << "\n";
+    printStats(stats);
+    if (remoteHead == "ref: " + ref) {
+        std::cout << "Note: the remote's working tree for '" << branch << "' was not updated\n";
+    }
+    return true;
+}
+
+} // namespace MiniGit
@@ -0,0 +1,193 @@
+#include "minigit.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <tuple>
+
+namespace MiniGit {
+
+namespace {
+    // MinHash sketch: SKETCH_SIZE minimums, banded for locality-sensitive
+    // bucketing so only files sharing a band are ever compared
+    const size_t SKETCH_SIZE = 64;
+    const size_t BAND_ROWS = 4;
+    const size_t MAX_SHINGLE = 64;                     // long lines are split
+    const size_t MAX_SKETCH_BYTES = 8 * 1024 * 1024;   // larger blobs pair by hash only
+
+    struct Sketch {
+        std::array<uint64_t, SKETCH_SIZE> mins;
+        size_t size = 0;
+        bool valid = false;
+    };
+
+    // Shingles are lines (or MAX_SHINGLE-byte pieces of longer ones); each
+    // of the SKETCH_SIZE hash functions is the shingle hash under a seed
+    Sketch sketchOf(const std::string& blobHash) {
+        Sketch sketch;
+        sketch.mins.fill(std::numeric_limits<uint64_t>::max());
+        if (ChunkStore::isChunked(blobHash)) return sketch;
+
+        ObjectView object = Utils::readObject(blobHash);
+        if (object.empty() || object.size() > MAX_SKETCH_BYTES) return sketch;
+        std::string_view content = object.view();
+        sketch.size = content.size();
+
+        std::unordered_set<uint64_t> shingles;
+        while (!content.empty()) {
+            size_t eol = content.find('\n');
+            size_t length = std::min(eol == std::string_view::npos ? content.size() : eol + 1, MAX_SHINGLE);
+            shingles.insert(Utils::fnv1a(content.substr(0, length)));
+            content.remove_prefix(length);
+        }
+        for (uint64_t shingle : shingles) {
+            for (size_t i = 0; i < SKETCH_SIZE; ++i) {
+                uint64_t value = Utils::mix(shingle ^ (0x9e3779b97f4a7c15ULL * (i + 1)));
+                if (value < sketch.mins[i]) sketch.mins[i] = value;
+            }
+        }
+        sketch.valid = true;
+        return sketch;
+    }
+
+    // Estimated Jaccard similarity of the line sets, capped by the size ratio
+    int similarity(const Sketch& a, const Sketch& b) {
+        size_t equal = 0;
+        for (size_t i = 0; i < SKETCH_SIZE; ++i) equal += a.mins[i] == b.mins[i];
+        int score = static_cast<int>(equal * 100 / SKETCH_SIZE);
+        size_t larger = std::max(a.size, b.size);
+        if (larger > 0) {
+            score = std::min(score, static_cast<int>(std::min(a.size, b.size) * 100 / larger));
+        }
+        return score;
+    }
+
+    std::string_view baseName(const std::string& path) {
+        size_t slash = path.rfind('/');
+        return slash == std::string::npos ? std::string_view(path) : std::string_view(path).substr(slash + 1);
+    }
+
+    struct Candidate {
+        int score;
+        bool sameName;
+        size_t source;
+        size_t target;
+    };
+}
+
+// Pair paths deleted from before with paths added in after. Identical blobs
+// pair first through a hash index; the rest are compared by MinHash sketches
+// computed in parallel, and only pairs that collide in a sketch band are
+// scored, so thousands of adds and deletes never meet pairwise. With copies,
+// every path of before (not only deleted ones) may be a source.
+std::vector<RenameDetector::Rename> RenameDetector::detect(
+    const std::unordered_map<std::string, std::string>& before,
+    const std::unordered_map<std::string, std::string>& after,
+    bool copies, int minSimilarity) {
+    std::vector<Rename> renames;
+
+    std::vector<std::string> sources, targets;
+    for (const auto& [path, hash] : before) {
+        if (copies || !after.count(path)) sources.push_back(path);
+    }
+    for (const auto& [path, hash] : after) {
+        if (!before.count(path)) targets.push_back(path);
+    }
+    if (sources.empty() || targets.empty()) return renames;
+    std::sort(sources.begin(), sources.end());
+    std::sort(targets.begin(), targets.end());
+
+    auto isDeleted = [&](size_t source) { return !after.count(sources[source]); };
+    std::vector<char> sourceUsed(sources.size(), 0), targetUsed(targets.size(), 0);
+
+    // Pass 1: exact renames by blob hash, preferring an unchanged file name
+    std::unordered_map<std::string, std::vector<size_t>> byHash;
+    for (size_t i = 0; i < sources.size(); ++i) byHash[before.at(sources[i])].push_back(i);
+    const std::string emptyBlob = Utils::computeSHA1("");
+    for (size_t t = 0; t < targets.size(); ++t) {
+        auto bucket = byHash.find(after.at(targets[t]));
+        if (bucket == byHash.end() || bucket->first == emptyBlob) continue;
+
+        // Prefer a deleted source (a rename over a copy), then a kept name
+        auto rank = [&](size_t source) {
+            return std::make_pair(isDeleted(source), baseName(sources[source]) == baseName(targets[t]));
+        };
+        size_t best = sources.size();
+        for (size_t source : bucket->second) {
+            if (sourceUsed[source] && isDeleted(source)) continue;
+            if (best == sources.size() || rank(source) > rank(best)) best = source;
+        }
+        if (best == sources.size()) continue;
+        if (isDeleted(best)) sourceUsed[best] = 1;
+        targetUsed[t] = 1;
+        renames.push_back({sources[best], targets[t], 100, !isDeleted(best)});
+    }
+
+    // Pass 2: similar content among what is left
+    std::vector<size_t> openSources, openTargets;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (!sourceUsed[i] || !isDeleted(i)) openSources.push_back(i);
+    }
+    for (size_t t = 0; t < targets.size(); ++t) {
+        if (!targetUsed[t]) openTargets.push_back(t);
+    }
+    if (openSources.empty() || openTargets.empty()) return renames;
+
+    std::vector<Sketch> sourceSketches(openSources.size()), targetSketches(openTargets.size());
+    Utils::parallelFor(openSources.size() + openTargets.size(), [&](size_t i) {
+        if (i < openSources.size()) {
+            sourceSketches[i] = sketchOf(before.at(sources[openSources[i]]));
+        } else {
+            size_t t = i - openSources.size();
+            targetSketches[t] = sketchOf(after.at(targets[openTargets[t]]));
+        }
+    });
+
+    auto bandKey = [](const Sketch& sketch, size_t band) {
+        uint64_t key = band;
+        for (size_t row = 0; row < BAND_ROWS; ++row) key = Utils::mix(key ^ sketch.mins[band * BAND_ROWS + row]);
+        return key;
+    };
+
+    std::unordered_map<uint64_t, std::vector<size_t>> buckets;
+    for (size_t s = 0; s < openSources.size(); ++s) {
+        if (!sourceSketches[s].valid) continue;
+        for (size_t band = 0; band < SKETCH_SIZE / BAND_ROWS; ++band) {
+            buckets[bandKey(sourceSketches[s], band)].push_back(s);
+        }
+    }
+
+    std::vector<Candidate> candidates;
+    for (size_t t = 0; t < openTargets.size(); ++t) {
+        if (!targetSketches[t].valid) continue;
+        std::unordered_set<size_t> compared;
+        for (size_t band = 0; band < SKETCH_SIZE / BAND_ROWS; ++band) {
+            auto bucket = buckets.find(bandKey(targetSketches[t], band));
+            if (bucket == buckets.end()) continue;
+            for (size_t s : bucket->second) {
+                if (!compared.insert(s).second) continue;
+                int score = similarity(sourceSketches[s], targetSketches[t]);
+                if (score < minSimilarity) continue;
+                bool sameName = baseName(sources[openSources[s]]) == baseName(targets[openTargets[t]]);
+                candidates.push_back({score, sameName, s, t});
+            }
+        }
+    }
+
+    // Best pairs first; a deleted source is consumed by its first match
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.score != b.score) return a.score > b.score;
+        if (a.sameName != b.sameName) return a.sameName;
+        return std::tie(a.source, a.target) < std::tie(b.source, b.target);
+    });
+    for (const auto& candidate : candidates) {
+        size_t source = openSources[candidate.source];
+        size_t target = openTargets[candidate.target];
+        if (targetUsed[target] || (sourceUsed[source] && isDeleted(source))) continue;
+        if (isDeleted(source)) sourceUsed[source] = 1;
+        targetUsed[target] = 1;
+        renames.push_back({sources[source], targets[target], candidate.score, !isDeleted(source)});
+    }
+    return renames;
+}
+
+} // namespace MiniGit
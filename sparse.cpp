@@ -0,0 +1,127 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <unordered_set>
+
+namespace MiniGit {
+
+namespace {
+    // Cones compiled once per process: the cone directories themselves and
+    // every ancestor directory whose immediate files are also included
+    struct ConeSet {
+        bool loaded = false;
+        std::vector<std::string> patterns;
+        std::unordered_set<std::string> cones;
+        std::unordered_set<std::string> ancestors;
+    };
+
+    ConeSet& coneSet() {
+        static ConeSet set;
+        return set;
+    }
+
+    std::string normalizeCone(std::string pattern) {
+        std::replace(pattern.begin(), pattern.end(), '\\', '/');
+        while (!pattern.empty() && pattern.front() == '/') pattern.erase(0, 1);
+        while (!pattern.empty() && pattern.back() == '/') pattern.pop_back();
+        if (pattern.rfind("./", 0) == 0) pattern.erase(0, 2);
+        return pattern;
+    }
+
+    void compile(ConeSet& set, const std::vector<std::string>& patterns) {
+        set.patterns.clear();
+        set.cones.clear();
+        set.ancestors.clear();
+        for (const auto& raw : patterns) {
+            std::string cone = normalizeCone(raw);
+            if (cone.empty() || set.cones.count(cone)) continue;
+            set.patterns.push_back(cone);
+            set.cones.insert(cone);
+            for (size_t slash = cone.find('/'); slash != std::string::npos;
+                 slash = cone.find('/', slash + 1)) {
+                set.ancestors.insert(cone.substr(0, slash));
+            }
+        }
+        set.loaded = true;
+    }
+
+    const ConeSet& loadedConeSet() {
+        ConeSet& set = coneSet();
+        if (!set.loaded) {
+            std::vector<std::string> patterns;
+            std::ifstream file(Constants::SPARSE_FILE);
+            std::string line;
+            while (std::getline(file, line)) {
+                if (!line.empty() && line[0] != '#') patterns.push_back(line);
+            }
+            compile(set, patterns);
+        }
+        return set;
+    }
+}
+
+bool SparseCheckout::isEnabled() {
+    return !loadedConeSet().cones.empty();
+}
+
+// Check whether a repository-relative path falls inside the sparse cones
+bool SparseCheckout::contains(const std::string& path) {
+    const ConeSet& set = loadedConeSet();
+    if (set.cones.empty()) return true;
+
+    size_t lastSlash = path.rfind('/');
+    if (lastSlash == std::string::npos) return true;  // top-level file
+
+    // Under a cone: some leading directory prefix is itself a cone
+    for (size_t slash = path.find('/'); slash != std::string::npos;
+         slash = path.find('/', slash + 1)) {
+        if (set.cones.count(path.substr(0, slash))) return true;
+    }
+
+    // Immediate file of a directory on the way down to a cone
+    return set.ancestors.count(path.substr(0, lastSlash)) > 0;
+}
+
+// Check whether a directory may hold in-cone files (lets walkers prune)
+bool SparseCheckout::containsDirectory(const std::string& directory) {
+    const ConeSet& set = loadedConeSet();
+    if (set.cones.empty() || directory.empty() || directory == ".") return true;
+    if (set.cones.count(directory) || set.ancestors.count(directory)) return true;
+
+    for (size_t slash = directory.find('/'); slash != std::string::npos;
+         slash = directory.find('/', slash + 1)) {
+        if (set.cones.count(directory.substr(0, slash))) return true;
+    }
+    return false;
+}
+
+std::vector<std::string> SparseCheckout::getPatterns() {
+    return loadedConeSet().patterns;
+}
+
+bool SparseCheckout::setPatterns(const std::vector<std::string>& patterns) {
+    ConeSet& set = coneSet();
+    compile(set, patterns);
+
+    std::string content;
+    for (const auto& cone : set.patterns) {
+        content += cone + "\n";
+    }
+    if (!Utils::writeFile(Constants::SPARSE_FILE, content)) {
+        std::cerr << "Error: Could not write " << Constants::SPARSE_FILE << "\n";
+        return false;
+    }
+    WorkingTree::invalidate();  // the cache only covers in-cone files
+    return true;
+}
+
+bool SparseCheckout::disable() {
+    compile(coneSet(), {});
+    WorkingTree::invalidate();
+    std::error_code ec;
+    std::filesystem::remove(Constants::SPARSE_FILE, ec);
+    return !ec;
+}
+
+} // namespace MiniGit
@@ -7,13 +7,148 @@
 #include <random>
 #include <filesystem>
 #include <iostream>
+#include <cerrno>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace MiniGit {
 
+namespace {
+    // Small-object read buffers are recycled instead of reallocated per read
+    std::mutex bufferPoolMutex;
+    std::vector<std::string> bufferPool;
+    const size_t BUFFER_POOL_LIMIT = 32;
+
+    std::string acquireBuffer() {
+        std::lock_guard<std::mutex> lock(bufferPoolMutex);
+        if (bufferPool.empty()) {
+            std::string buffer;
+            buffer.reserve(ObjectView::MMAP_THRESHOLD);
+            return buffer;
+        }
+        std::string buffer = std::move(bufferPool.back());
+        bufferPool.pop_back();
+        return buffer;
+    }
+
+    void recycleBuffer(std::string&& buffer) {
+        if (buffer.capacity() < ObjectView::MMAP_THRESHOLD / 16 ||
+            buffer.capacity() > ObjectView::MMAP_THRESHOLD * 2) return;
+        buffer.clear();
+        std::lock_guard<std::mutex> lock(bufferPoolMutex);
+        if (bufferPool.size() < BUFFER_POOL_LIMIT) {
+            bufferPool.push_back(std::move(buffer));
+        }
+    }
+}
+
+ObjectView::~ObjectView() {
+    release();
+}
+
+ObjectView::ObjectView(ObjectView&& other) noexcept {
+    *this = std::move(other);
+}
+
+ObjectView& ObjectView::operator=(ObjectView&& other) noexcept {
+    if (this != &other) {
+        release();
+        mapping = std::exchange(other.mapping, nullptr);
+        buffer = std::move(other.buffer);
+        length = std::exchange(other.length, 0);
+        isOpen = std::exchange(other.isOpen, false);
+        ptr = mapping ? static_cast<const char*>(mapping) : buffer.data();
+        other.ptr = nullptr;
+    }
+    return *this;
+}
+
+void ObjectView::release() {
+#ifndef _WIN32
+    if (mapping) {
+        munmap(mapping, length);
+        mapping = nullptr;
+    }
+#endif
+    if (buffer.capacity() > 0) {
+        recycleBuffer(std::move(buffer));
+        buffer = std::string();
+    }
+    ptr = nullptr;
+    length = 0;
+    isOpen = false;
+}
+
+// Open a file as a view: mmap for large files, one sized read for small ones
+ObjectView ObjectView::open(const std::string& path) {
+    ObjectView result;
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return result;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return result;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+
+    if (size >= MMAP_THRESHOLD) {
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            madvise(addr, size, MADV_SEQUENTIAL);
+            ::close(fd);
+            result.mapping = addr;
+            result.ptr = static_cast<const char*>(addr);
+            result.length = size;
+            result.isOpen = true;
+            return result;
+        }
+    }
+
+    result.buffer = acquireBuffer();
+    result.buffer.resize(size);
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::read(fd, result.buffer.data() + done, size - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    result.buffer.resize(done);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return result;
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    result.buffer = acquireBuffer();
+    result.buffer.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    file.read(result.buffer.data(), size);
+    result.buffer.resize(static_cast<size_t>(file.gcount()));
+#endif
+    result.ptr = result.buffer.data();
+    result.length = result.buffer.size();
+    result.isOpen = true;
+    return result;
+}
+
 // Compute SHA-1 hash of file content (used to identify file versions)
-std::string Utils::computeSHA1(const std::string& content) {
+std::string Utils::computeSHA1(std::string_view content) {
     unsigned char hash[SHA_DIGEST_LENGTH];
-    SHA1((const unsigned char*)content.c_str(), content.size(), hash);
+    SHA1((const unsigned char*)content.data(), content.size(), hash);
 
     std::ostringstream oss;
     for (int i = 0; i < SHA_DIGEST_LENGTH; i++) {
@@ -22,6 +157,28 @@ std::string Utils::computeSHA1(const std::string& content) {
     return oss.str();
 }
 
+// Stable 64-bit FNV-1a hash, for anything persisted or compared across
+// runs (std::hash is neither)
+uint64_t Utils::fnv1a(std::string_view text) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// 64-bit finalizer (MurmurHash3 fmix64): spreads every input bit over the
+// whole word, so any slice of the result is usable as a hash
+uint64_t Utils::mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
 // Generate a unique hash (based on time and random value) — used for commit IDs
 std::string Utils::generateHash() {
     auto now = std::chrono::system_clock::now();
@@ -41,18 +198,17 @@ std::string Utils::generateHash() {
 
 // Read content from a file (returns empty string if file can't be opened)
 std::string Utils::readFile(const std::string& path) {
-    std::ifstream file(path);
-    if (!file.is_open()) return "";
-    return {std::istreambuf_iterator<char>(file), 
-            std::istreambuf_iterator<char>()};
+    ObjectView file = ObjectView::open(path);
+    if (!file.valid()) return "";
+    return file.str();
 }
 
 // Write content to a file
-bool Utils::writeFile(const std::string& path, const std::string& content) {
-    std::ofstream file(path);
+bool Utils::writeFile(const std::string& path, std::string_view content) {
+    std::ofstream file(path, std::ios::binary);
     if (!file) return false;
-    file << content;
-    return true;
+    file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    return static_cast<bool>(file);
 }
 
 // Create a directory (used for .minigit and object folders)
@@ -68,7 +224,7 @@ bool Utils::makeDirectory(const std::string& path) {
 }
 
 // Write blob object to object store (.minigit/objects/XX/...)
-bool Utils::writeObject(const std::string& hash, const std::string& content) {
+bool Utils::writeObject(const std::string& hash, std::string_view content) {
     if (hash.length() != 40) return false;
 
     std::string objectDir = Constants::OBJECTS_DIR + "/" + hash.substr(0, 2);
@@ -78,13 +234,113 @@ bool Utils::writeObject(const std::string& hash, const std::string& content) {
     return writeFile(objectPath, content);
 }
 
+// Path of an object inside the object store (.minigit/objects/XX/...)
+std::string Utils::objectPath(const std::string& hash) {
+    return Constants::OBJECTS_DIR + "/" + hash.substr(0, 2) + "/" + hash.substr(2);
+}
+
+// Borrow an object's bytes without copying (invalid view if missing)
+ObjectView Utils::readObject(const std::string& hash) {
+    if (hash.length() != 40) return ObjectView();
+    return ObjectView::open(objectPath(hash));
+}
+
+// Parse a commit object's header and manifest lines
+bool Utils::readCommit(const std::string& hash, CommitInfo& commit) {
+    ObjectView object = readObject(hash);
+    if (!object.valid()) return false;
+
+    std::string_view content = object.view();
+    while (!content.empty()) {
+        size_t eol = content.find('\n');
+        std::string_view line = content.substr(0, eol);
+        content = eol == std::string_view::npos ? std::string_view() : content.substr(eol + 1);
+
+        if (line.rfind("message ", 0) == 0) {
+            commit.message = std::string(line.substr(8));
+        } else if (line.rfind("time ", 0) == 0) {
+            commit.time = static_cast<std::time_t>(std::strtoll(std::string(line.substr(5)).c_str(), nullptr, 10));
+        } else if (line.rfind("parent ", 0) == 0) {
+            if (line.size() > 7) commit.parents.emplace_back(line.substr(7));
+        } else if (line.rfind("branch ", 0) == 0) {
+            commit.branch = std::string(line.substr(7));
+        } else if (line.rfind("manifest ", 0) == 0) {
+            commit.manifest = std::string(line.substr(9));
+        } else if (line.rfind("file ", 0) == 0) {
+            size_t space = line.find(' ', 5);
+            if (space != std::string_view::npos) {
+                commit.files.emplace_back(std::string(line.substr(5, space - 5)),
+                                          std::string(line.substr(space + 1)));
+            }
+        }
+    }
+    return true;
+}
+
 // Read content of a blob object from object store
 std::string Utils::readBlobContent(const std::string& hash) {
-    if (hash.empty() || hash.length() != 40) return "";
-    std::string path = Constants::OBJECTS_DIR + "/" + 
-                       hash.substr(0, 2) + "/" + 
-                       hash.substr(2);
-    return readFile(path);
+    ObjectView object = readObject(hash);
+    if (!object.valid()) return "";
+    if (ChunkStore::isChunkList(object.view())) {
+        std::string content;
+        return ChunkStore::readContent(object.view(), content) ? content : "";
+    }
+    return object.str();
+}
+
+void ByteBudget::acquire(size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex);
+    available.wait(lock, [&] {
+        return inFlight == 0 || inFlight + bytes <= limit;
+    });
+    inFlight += bytes;
+}
+
+void ByteBudget::release(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        inFlight -= bytes;
+    }
+    available.notify_all();
+}
+
+// Number of worker threads to use for parallel object work
+unsigned Utils::workerCount() {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores == 0 ? 4 : cores;
+}
+
+// Run body(0..count-1) across a worker pool; rethrows the first exception
+void Utils::parallelFor(size_t count, const std::function<void(size_t)>& body) {
+    size_t threads = std::min<size_t>(workerCount(), count);
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) body(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    auto worker = [&] {
+        for (size_t i = next++; i < count; i = next++) {
+            try {
+                body(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+                next = count;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+
+    if (failure) std::rethrow_exception(failure);
 }
 
 } // namespace MiniGit
@@ -0,0 +1,264 @@
+#include "minigit.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+
+namespace MiniGit {
+
+namespace {
+    // A file whose mtime is this close to the moment it was hashed could
+    // still change within the same timestamp, so its entry is not trusted
+    const auto RACY_WINDOW = std::chrono::seconds(2);
+
+    struct TreeState {
+        bool loaded = false;
+        bool dirty = false;
+        std::string token;
+        std::map<std::string, WorkingTree::Entry> entries;
+    };
+
+    TreeState& treeState() {
+        static TreeState state;
+        return state;
+    }
+
+    // File format: "token <fsmonitor token or ->", then one
+    // "<size> <mtime> <hash> <path>" line per file
+    void load(TreeState& state) {
+        std::ifstream file(Constants::WORKTREE_FILE);
+        std::string line;
+        if (std::getline(file, line) && line.rfind("token ", 0) == 0) {
+            state.token = line.substr(6) == "-" ? "" : line.substr(6);
+        }
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            WorkingTree::Entry entry;
+            long long mtime = 0;
+            if (!(fields >> entry.size >> mtime >> entry.hash)) continue;
+            entry.mtime = mtime;
+            std::string path;
+            std::getline(fields >> std::ws, path);
+            if (!path.empty()) state.entries[path] = std::move(entry);
+        }
+        state.loaded = true;
+    }
+
+    bool statFile(const std::string& path, uintmax_t& size, long long& mtime) {
+        std::error_code ec;
+        size = std::filesystem::file_size(path, ec);
+        if (ec) return false;
+        auto time = std::filesystem::last_write_time(path, ec);
+        if (ec) return false;
+        mtime = static_cast<long long>(time.time_since_epoch().count());
+        return true;
+    }
+
+    bool isRacy(const std::string& path) {
+        std::error_code ec;
+        auto time = std::filesystem::last_write_time(path, ec);
+        return ec || time > std::filesystem::file_time_type::clock::now() - RACY_WINDOW;
+    }
+
+    bool underPath(const std::string& path, const std::string& dir) {
+        return path.size() > dir.size() && path.compare(0, dir.size(), dir) == 0 && path[dir.size()] == '/';
+    }
+}
+
+// Bring the cached hash of every tracked-or-untracked (non-ignored, in-cone)
+// file up to date and return the table. With a running fsmonitor that has
+// covered the interval since the last refresh, only the paths it reported
+// are looked at; otherwise the tree (or only the directory root, when the
+// caller needs no more) is walked and files whose size or mtime changed
+// are re-hashed. Entries outside root may then be stale.
+const std::map<std::string, WorkingTree::Entry>& WorkingTree::refresh(const std::string& root) {
+    TreeState& state = treeState();
+    if (!state.loaded) load(state);
+
+    std::unordered_set<std::string> reported;
+    std::string newToken;
+    bool incremental = !state.token.empty() && FsMonitor::changedSince(state.token, reported, newToken) &&
+                       !reported.count(Constants::IGNORE_FILE);
+
+    std::vector<std::string> candidates;
+    if (incremental) {
+        for (const auto& path : reported) {
+            std::error_code ec;
+            auto status = std::filesystem::symlink_status(path, ec);
+            if (std::filesystem::is_directory(status)) {
+                if (IgnoreRules::isIgnored(path, true) || !SparseCheckout::containsDirectory(path)) continue;
+                for (auto& file : FileAdder::listFiles(path)) candidates.push_back(std::move(file));
+            } else if (std::filesystem::is_regular_file(status)) {
+                if (IgnoreRules::isIgnored(path, false) || !SparseCheckout::contains(path)) continue;
+                candidates.push_back(path);
+            } else {
+                // Gone (or never a file): drop it and anything that was below it
+                state.dirty |= state.entries.erase(path) > 0;
+                for (auto it = state.entries.lower_bound(path + "/");
+                     it != state.entries.end() && underPath(it->first, path);) {
+                    it = state.entries.erase(it);
+                    state.dirty = true;
+                }
+            }
+        }
+    } else {
+        // Take the token first so changes made during the walk are reported
+        // next time. A walk of one directory does not vouch for the rest of
+        // the tree, so it keeps the old token.
+        bool whole = root == ".";
+        newToken = whole ? FsMonitor::currentToken() : state.token;
+        candidates = FileAdder::listFiles(root);
+        std::unordered_set<std::string> present(candidates.begin(), candidates.end());
+        auto it = whole ? state.entries.begin() : state.entries.lower_bound(root + "/");
+        while (it != state.entries.end() && (whole || underPath(it->first, root))) {
+            if (present.count(it->first)) {
+                ++it;
+            } else {
+                it = state.entries.erase(it);
+                state.dirty = true;
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // Stat every candidate; re-hash (in parallel) only those that changed
+    std::vector<Entry> fresh(candidates.size());
+    std::vector<char> changed(candidates.size(), 0);
+    Utils::parallelFor(candidates.size(), [&](size_t i) {
+        Entry& entry = fresh[i];
+        if (!statFile(candidates[i], entry.size, entry.mtime)) return;
+        auto cached = state.entries.find(candidates[i]);
+        if (cached != state.entries.end() && cached->second.mtime != 0 &&
+            cached->second.size == entry.size && cached->second.mtime == entry.mtime) {
+            return;
+        }
+        ObjectView content = ObjectView::open(candidates[i]);
+        if (!content.valid()) return;
+        entry.hash = Utils::computeSHA1(content.view());
+        if (isRacy(candidates[i])) entry.mtime = 0;
+        changed[i] = 1;
+    });
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (!changed[i]) continue;
+        state.entries[candidates[i]] = std::move(fresh[i]);
+        state.dirty = true;
+    }
+
+    if (newToken != state.token) {
+        state.token = newToken;
+        state.dirty = true;
+    }
+    save();
+    return state.entries;
+}
+
+// Note a file just written with known content (checkout, merge)
+void WorkingTree::record(const std::string& path, const std::string& hash) {
+    TreeState& state = treeState();
+    if (!state.loaded) load(state);
+    Entry entry;
+    if (!statFile(path, entry.size, entry.mtime)) return;
+    if (isRacy(path)) entry.mtime = 0;
+    entry.hash = hash;
+    state.entries[path] = std::move(entry);
+    state.dirty = true;
+}
+
+bool WorkingTree::save() {
+    TreeState& state = treeState();
+    if (!state.dirty) return true;
+
+    std::string content = "token " + (state.token.empty() ? std::string("-") : state.token) + "\n";
+    for (const auto& [path, entry] : state.entries) {
+        content += std::to_string(entry.size) + " " + std::to_string(entry.mtime) + " " +
+                   entry.hash + " " + path + "\n";
+    }
+    std::string temp = Constants::WORKTREE_FILE + ".lock";
+    std::error_code ec;
+    if (!Utils::writeFile(temp, content)) return false;
+    std::filesystem::rename(temp, Constants::WORKTREE_FILE, ec);
+    state.dirty = ec.operator bool();
+    return !ec;
+}
+
+// Forget the cache (e.g. after the sparse cones change which files count)
+void WorkingTree::invalidate() {
+    TreeState& state = treeState();
+    state.entries.clear();
+    state.token.clear();
+    state.loaded = true;
+    state.dirty = false;
+    std::error_code ec;
+    std::filesystem::remove(Constants::WORKTREE_FILE, ec);
+}
+
+// Compare HEAD, the staging area and the working tree
+bool WorkingTree::showStatus() {
+    if (!Initializer::isInitialized()) {
+        std::cerr << "Error: Repository not initialized\n";
+        return false;
+    }
+
+    std::string branch = BranchManager::getCurrentBranch();
+    std::string head = RefStore::resolveHead();
+    auto headFiles = MergeManager::getCommitFiles(head);
+    auto staged = FileAdder::getStagedEntries();
+    const auto& work = refresh();
+
+    std::vector<std::string> toCommit, notStaged, untracked;
+    for (const auto& [path, hash] : staged) {
+        auto it = headFiles.find(path);
+        if (hash.empty()) {
+            if (it != headFiles.end()) toCommit.push_back("deleted:    " + path);
+        } else if (it == headFiles.end()) {
+            toCommit.push_back("new file:   " + path);
+        } else if (it->second != hash) {
+            toCommit.push_back("modified:   " + path);
+        }
+    }
+
+    auto expected = headFiles;
+    for (const auto& [path, hash] : staged) {
+        if (hash.empty()) expected.erase(path);
+        else expected[path] = hash;
+    }
+    for (const auto& [path, hash] : expected) {
+        if (!SparseCheckout::contains(path)) continue;
+        auto it = work.find(path);
+        if (it == work.end()) {
+            notStaged.push_back("deleted:    " + path);
+        } else if (it->second.hash != hash) {
+            notStaged.push_back("modified:   " + path);
+        }
+    }
+    for (const auto& [path, entry] : work) {
+        if (!expected.count(path)) untracked.push_back(path);
+    }
+
+    std::sort(toCommit.begin(), toCommit.end(), [](const std::string& a, const std::string& b) {
+        return a.substr(12) < b.substr(12);
+    });
+    std::sort(notStaged.begin(), notStaged.end(), [](const std::string& a, const std::string& b) {
+        return a.substr(12) < b.substr(12);
+    });
+
+    std::string out = branch.empty() ? "HEAD detached at " + head.substr(0, 7) + "\n" : "On branch " + branch + "\n";
+    auto section = [&](const char* title, const std::vector<std::string>& lines) {
+        if (lines.empty()) return;
+        out += std::string("\n") + title + ":\n";
+        for (const auto& line : lines) out += "  " + line + "\n";
+    };
+    section("Changes to be committed", toCommit);
+    section("Changes not staged for commit", notStaged);
+    section("Untracked files", untracked);
+    if (toCommit.empty() && notStaged.empty() && untracked.empty()) {
+        out += "nothing to commit, working tree clean\n";
+    }
+    std::cout << out;
+    return true;
+}
+
+} // namespace MiniGit